@@ -32,8 +32,8 @@ int main(int argc, char* argv[]) {
     
     std::cout << "检测到 " << edge_loops.size() << " 个边环:" << std::endl;
     for (size_t i = 0; i < edge_loops.size(); ++i) {
-        std::cout << "  边环 " << i << ": " << edge_loops[i].size() 
-                  << " 个顶点" << std::endl;
+        std::cout << "  边环 " << i << ": " << edge_loops[i].vertices.size()
+                  << " 个顶点" << (edge_loops[i].closed ? "（闭合）" : "（开放）") << std::endl;
     }
     
     // 使用边环分割网格
@@ -70,7 +70,8 @@ int main(int argc, char* argv[]) {
             out << "检测结果:\n";
             out << "  边环数量: " << edge_loops.size() << "\n";
             for (size_t i = 0; i < edge_loops.size(); ++i) {
-                out << "  边环 " << i << ": " << edge_loops[i].size() << " 个顶点\n";
+                out << "  边环 " << i << ": " << edge_loops[i].vertices.size() << " 个顶点"
+                    << (edge_loops[i].closed ? "（闭合）" : "（开放）") << "\n";
             }
             out << "\n";
             
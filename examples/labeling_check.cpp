@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <igl/read_triangle_mesh.h>
+#include "uv_segmentation.h"
+
+using namespace UVSegmentation;
+
+// 比较两种岛划分算法的输出：面标签、每个岛的面集合、每个岛的边界边集合
+static bool sameIslands(const IslandSet& a, const IslandSet& b) {
+    if (a.numIslands() != b.numIslands()) {
+        std::cout << "    岛数量不同: " << a.numIslands() << " vs " << b.numIslands() << "\n";
+        return false;
+    }
+    if (a.face_island != b.face_island) {
+        std::cout << "    face_island 不同\n";
+        return false;
+    }
+    for (int i = 0; i < a.numIslands(); i++) {
+        std::vector<int> faces_a(a.islandFaces(i).begin(), a.islandFaces(i).end());
+        std::vector<int> faces_b(b.islandFaces(i).begin(), b.islandFaces(i).end());
+        std::sort(faces_a.begin(), faces_a.end());
+        std::sort(faces_b.begin(), faces_b.end());
+        if (faces_a != faces_b) {
+            std::cout << "    岛 " << i << " 的面集合不同\n";
+            return false;
+        }
+
+        std::vector<Edge> boundary_a(a.islandBoundary(i).begin(), a.islandBoundary(i).end());
+        std::vector<Edge> boundary_b(b.islandBoundary(i).begin(), b.islandBoundary(i).end());
+        std::sort(boundary_a.begin(), boundary_a.end());
+        std::sort(boundary_b.begin(), boundary_b.end());
+        if (boundary_a != boundary_b) {
+            std::cout << "    岛 " << i << " 的边界边不同\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cout << "用法: " << argv[0] << " <mesh.obj>\n";
+        return 1;
+    }
+
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi F;
+
+    std::cout << "加载网格: " << argv[1] << "\n";
+    if (!igl::read_triangle_mesh(argv[1], V, F)) {
+        std::cerr << "无法读取网格\n";
+        return 1;
+    }
+
+    std::cout << "网格: " << V.rows() << " 顶点, " << F.rows() << " 面\n\n";
+
+    auto topo = buildMeshTopology(V, F);
+
+    SegmentationOptions bfs;
+    bfs.labeling = IslandLabeling::BreadthFirst;
+    SegmentationOptions union_find;
+    union_find.labeling = IslandLabeling::UnionFind;
+
+    bool ok = true;
+    auto check = [&](const std::string& name, const IslandSet& a, const IslandSet& b) {
+        bool same = sameIslands(a, b);
+        std::cout << "  " << name << ": " << a.numIslands() << " 个岛, "
+                  << (same ? "一致" : "不一致") << "\n";
+        ok = ok && same;
+    };
+
+    std::cout << "比较 BreadthFirst 与 UnionFind:\n";
+
+    Eigen::Vector4d plane(1, 0, 0, 0);
+    check("对称分割",
+          segmentBySymmetry(V, F, topo, plane, 0.01, bfs),
+          segmentBySymmetry(V, F, topo, plane, 0.01, union_find));
+
+    check("高曲率分割",
+          segmentByHighCurvature(V, F, topo, 0.5, bfs),
+          segmentByHighCurvature(V, F, topo, 0.5, union_find));
+
+    // 每隔几条边切一刀，得到大量小岛
+    std::vector<int> cut_edge_ids;
+    for (int e = 0; e < topo.numEdges(); e += 3) {
+        cut_edge_ids.push_back(e);
+    }
+    check("稀疏切割边",
+          segmentByCutEdges(V, F, topo, cut_edge_ids, bfs),
+          segmentByCutEdges(V, F, topo, cut_edge_ids, union_find));
+
+    std::cout << "\n" << (ok ? "通过" : "失败") << "\n";
+    return ok ? 0 : 1;
+}
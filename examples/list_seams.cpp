@@ -1,58 +1,37 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
-#include <set>
 #include <igl/read_triangle_mesh.h>
 #include "uv_segmentation.h"
 
-// 从UV岛提取缝合线（边的顶点索引对）
-std::vector<std::pair<int, int>> extract_seams_from_islands(
-    const Eigen::MatrixXi& F,
-    const std::vector<UVSegmentation::UVIsland>& islands) {
-    
-    std::vector<std::pair<int, int>> seams;
-    
-    // 直接使用岛屿的边界边
-    for (const auto& island : islands) {
-        for (const auto& edge : island.boundary) {
-            seams.push_back({edge.v0, edge.v1});
-        }
-    }
-    
-    return seams;
-}
-
 void print_seams(const std::string& method_name,
-                 const std::vector<UVSegmentation::UVIsland>& islands,
-                 const Eigen::MatrixXi& F) {
-    
-    auto seams = extract_seams_from_islands(F, islands);
+                 const UVSegmentation::IslandSet& islands,
+                 const UVSegmentation::SeamGraph& seams) {
     
+    // 缝合线图中每条缝合边只出现一次
     std::cout << "\n" << method_name << ":\n";
-    std::cout << "  UV岛数量: " << islands.size() << "\n";
-    std::cout << "  缝合线数量: " << seams.size() << "\n";
-    
-    if (seams.size() <= 20) {
-        std::cout << "  缝合线列表:\n";
-        for (const auto& seam : seams) {
-            std::cout << "    边 (" << seam.first << ", " << seam.second << ")\n";
-        }
-    } else {
-        std::cout << "  前10条缝合线:\n";
-        for (size_t i = 0; i < 10 && i < seams.size(); i++) {
-            std::cout << "    边 (" << seams[i].first << ", " << seams[i].second << ")\n";
-        }
-        std::cout << "    ... (共 " << seams.size() << " 条)\n";
+    std::cout << "  UV岛数量: " << islands.numIslands() << "\n";
+    std::cout << "  缝合线数量: " << seams.numSeams() << "\n";
+    
+    const int shown = seams.numSeams() <= 20 ? seams.numSeams() : 10;
+    std::cout << (seams.numSeams() <= 20 ? "  缝合线列表:\n" : "  前10条缝合线:\n");
+    for (int i = 0; i < shown; i++) {
+        std::cout << "    边 (" << seams.edges[i].v0 << ", " << seams.edges[i].v1 << ")"
+                  << " 岛 " << seams.left_island[i] << " | " << seams.right_island[i]
+                  << " 长度 " << seams.lengths[i] << "\n";
+    }
+    if (shown < seams.numSeams()) {
+        std::cout << "    ... (共 " << seams.numSeams() << " 条)\n";
     }
     
     // 统计每个岛的面数
     std::cout << "  每个UV岛的面数: ";
-    for (size_t i = 0; i < islands.size() && i < 5; i++) {
-        std::cout << islands[i].faces.size();
-        if (i < islands.size() - 1) std::cout << ", ";
+    for (int i = 0; i < islands.numIslands() && i < 5; i++) {
+        std::cout << islands.islandFaces(i).size();
+        if (i < islands.numIslands() - 1) std::cout << ", ";
     }
-    if (islands.size() > 5) {
-        std::cout << ", ... (共 " << islands.size() << " 个岛)";
+    if (islands.numIslands() > 5) {
+        std::cout << ", ... (共 " << islands.numIslands() << " 个岛)";
     }
     std::cout << "\n";
 }
@@ -83,6 +62,9 @@ int main(int argc, char* argv[]) {
     
     using namespace UVSegmentation;
     
+    // 所有算法共用一份拓扑，缝合线图也基于它提取
+    MeshTopology topo = buildMeshTopology(V, F);
+    
     std::cout << "\n========================================\n";
     std::cout << "测试分割算法:\n";
     std::cout << "========================================\n";
@@ -90,10 +72,10 @@ int main(int argc, char* argv[]) {
     // 1. 边缘环分割
     try {
         std::cout << "\n[1/4] 边缘环分割...\n";
-        auto edge_loops = detectEdgeLoops(V, F, 30.0);
+        auto edge_loops = detectEdgeLoops(V, F, topo, 30.0);
         std::cout << "  检测到 " << edge_loops.size() << " 个边环\n";
-        auto islands = segmentByEdgeLoops(V, F, edge_loops);
-        print_seams("边缘环分割", islands, F);
+        auto islands = segmentByEdgeLoops(V, F, topo, edge_loops);
+        print_seams("边缘环分割", islands, buildSeamGraph(V, topo, islands));
     } catch (const std::exception& e) {
         std::cout << "✗ 失败: " << e.what() << "\n";
     }
@@ -101,8 +83,8 @@ int main(int argc, char* argv[]) {
     // 2. 高曲率分割
     try {
         std::cout << "\n[2/4] 高曲率分割...\n";
-        auto islands = segmentByHighCurvature(V, F, 0.5);
-        print_seams("高曲率分割", islands, F);
+        auto islands = segmentByHighCurvature(V, F, topo, 0.5);
+        print_seams("高曲率分割", islands, buildSeamGraph(V, topo, islands));
     } catch (const std::exception& e) {
         std::cout << "✗ 失败: " << e.what() << "\n";
     }
@@ -110,8 +92,8 @@ int main(int argc, char* argv[]) {
     // 3. 高斯曲率分割
     try {
         std::cout << "\n[3/4] 高斯曲率分割...\n";
-        auto islands = segmentByGaussianCurvature(V, F, 0.01);
-        print_seams("高斯曲率分割", islands, F);
+        auto islands = segmentByGaussianCurvature(V, F, topo, 0.01);
+        print_seams("高斯曲率分割", islands, buildSeamGraph(V, topo, islands));
     } catch (const std::exception& e) {
         std::cout << "✗ 失败: " << e.what() << "\n";
     }
@@ -120,8 +102,8 @@ int main(int argc, char* argv[]) {
     try {
         std::cout << "\n[4/4] 对称分割 (x=0平面)...\n";
         Eigen::Vector4d plane(1, 0, 0, 0); // x = 0平面
-        auto islands = segmentBySymmetry(V, F, plane, 0.01);
-        print_seams("对称分割", islands, F);
+        auto islands = segmentBySymmetry(V, F, topo, plane, 0.01);
+        print_seams("对称分割", islands, buildSeamGraph(V, topo, islands));
     } catch (const std::exception& e) {
         std::cout << "✗ 失败: " << e.what() << "\n";
     }
@@ -1,6 +1,9 @@
 #include <iostream>
+#include <unordered_map>
+#include <vector>
 #include <igl/read_triangle_mesh.h>
 #include <chrono>
+#include "uv_segmentation.h"
 
 int main(int argc, char* argv[]) {
     if (argc < 2) {
@@ -83,6 +86,86 @@ int main(int argc, char* argv[]) {
     }
     std::cout << "  负侧: " << neg << ", 平面上: " << zero << ", 正侧: " << pos << "\n\n";
     
+    // 测试4：岛屿 BFS（哈希查边 vs 面邻接表）
+    std::cout << "测试4: 岛屿 BFS 遍历 (无切割边)...\n";
+    
+    // 旧方法：每访问一个面，对它的3条边做哈希查找
+    start = std::chrono::high_resolution_clock::now();
+    std::unordered_map<std::pair<int,int>, std::vector<int>, PairHash> edge_to_faces;
+    edge_to_faces.reserve(F.rows() * 3);
+    for (int fi = 0; fi < F.rows(); ++fi) {
+        for (int j = 0; j < 3; ++j) {
+            int v0 = F(fi, j);
+            int v1 = F(fi, (j + 1) % 3);
+            if (v0 > v1) std::swap(v0, v1);
+            edge_to_faces[{v0, v1}].push_back(fi);
+        }
+    }
+    auto after_build = std::chrono::high_resolution_clock::now();
+    
+    std::vector<int> labels(F.rows(), -1);
+    std::vector<int> queue;
+    queue.reserve(F.rows());
+    int hash_islands = 0;
+    for (int seed = 0; seed < F.rows(); ++seed) {
+        if (labels[seed] >= 0) continue;
+        queue.clear();
+        queue.push_back(seed);
+        labels[seed] = hash_islands;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            int fi = queue[head];
+            for (int j = 0; j < 3; ++j) {
+                int v0 = F(fi, j);
+                int v1 = F(fi, (j + 1) % 3);
+                if (v0 > v1) std::swap(v0, v1);
+                for (int adj : edge_to_faces.find({v0, v1})->second) {
+                    if (labels[adj] < 0) {
+                        labels[adj] = hash_islands;
+                        queue.push_back(adj);
+                    }
+                }
+            }
+        }
+        ++hash_islands;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    auto hash_build_ms = std::chrono::duration_cast<std::chrono::milliseconds>(after_build - start).count();
+    auto hash_bfs_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - after_build).count();
+    
+    // 新方法：预先构建的面邻接表，BFS 只做数组索引
+    start = std::chrono::high_resolution_clock::now();
+    UVSegmentation::MeshTopology topo = UVSegmentation::buildMeshTopology(V, F);
+    after_build = std::chrono::high_resolution_clock::now();
+    
+    std::fill(labels.begin(), labels.end(), -1);
+    int table_islands = 0;
+    for (int seed = 0; seed < F.rows(); ++seed) {
+        if (labels[seed] >= 0) continue;
+        queue.clear();
+        queue.push_back(seed);
+        labels[seed] = table_islands;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            int fi = queue[head];
+            for (int j = 0; j < 3; ++j) {
+                int adj = topo.faceNeighbor(fi, j);
+                if (adj >= 0 && labels[adj] < 0) {
+                    labels[adj] = table_islands;
+                    queue.push_back(adj);
+                }
+            }
+        }
+        ++table_islands;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    auto table_build_ms = std::chrono::duration_cast<std::chrono::milliseconds>(after_build - start).count();
+    auto table_bfs_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - after_build).count();
+    
+    std::cout << "  哈希查边:   构建 " << hash_build_ms << " ms, BFS " << hash_bfs_ms
+              << " ms, 连通块 " << hash_islands << "\n";
+    std::cout << "  面邻接表:   构建 " << table_build_ms << " ms, BFS " << table_bfs_ms
+              << " ms, 连通块 " << table_islands << "\n";
+    std::cout << "  (面邻接表跳过非流形边，连通块数可能略多)\n\n";
+    
     std::cout << "性能分析完成！\n";
     std::cout << "结论: 如果测试1-3都很快，问题在segmentByEdgeLoops的BFS遍历\n";
     
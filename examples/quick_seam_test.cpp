@@ -23,20 +23,23 @@ int main(int argc, char* argv[]) {
     try {
         std::cout << "运行对称分割 (x=0平面)...\n";
         Eigen::Vector4d plane(1, 0, 0, 0);
-        auto islands = UVSegmentation::segmentBySymmetry(V, F, plane, 0.01);
+        auto topo = UVSegmentation::buildMeshTopology(V, F);
+        auto islands = UVSegmentation::segmentBySymmetry(V, F, topo, plane, 0.01);
+        auto seams = UVSegmentation::buildSeamGraph(V, topo, islands);
         
         std::cout << "\n结果:\n";
-        std::cout << "  UV岛数量: " << islands.size() << "\n";
+        std::cout << "  UV岛数量: " << islands.numIslands() << "\n";
         
-        int total_seams = 0;
-        for (const auto& island : islands) {
-            total_seams += island.boundary.size();
+        double seam_length = 0.0;
+        for (double length : seams.lengths) {
+            seam_length += length;
         }
-        std::cout << "  缝合线数量: " << total_seams << "\n";
+        std::cout << "  缝合线数量: " << seams.numSeams() << "\n";
+        std::cout << "  缝合线总长: " << seam_length << "\n";
         
         std::cout << "\n每个UV岛的面数:\n";
-        for (size_t i = 0; i < islands.size(); i++) {
-            std::cout << "  岛 " << i << ": " << islands[i].faces.size() << " 面\n";
+        for (int i = 0; i < islands.numIslands(); i++) {
+            std::cout << "  岛 " << i << ": " << islands.islandFaces(i).size() << " 面\n";
         }
         
     } catch (const std::exception& e) {
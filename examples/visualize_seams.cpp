@@ -1,7 +1,6 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
-#include <set>
 #include <cmath>
 #include <igl/read_triangle_mesh.h>
 #include <igl/edges.h>
@@ -46,11 +45,11 @@ public:
     }
     
     void drawSeams(const Eigen::MatrixXd& V2D, 
-                   const std::vector<std::pair<int, int>>& seams,
+                   const UVSegmentation::SeamGraph& seams,
                    const std::string& color = "#dc3545") {
-        for (const auto& edge : seams) {
-            Eigen::Vector2d p0 = V2D.row(edge.first);
-            Eigen::Vector2d p1 = V2D.row(edge.second);
+        for (const auto& edge : seams.edges) {
+            Eigen::Vector2d p0 = V2D.row(edge.v0);
+            Eigen::Vector2d p1 = V2D.row(edge.v1);
             
             file_ << "<line x1=\"" << p0.x() << "\" y1=\"" << p0.y() << "\" ";
             file_ << "x2=\"" << p1.x() << "\" y2=\"" << p1.y() << "\" ";
@@ -60,28 +59,25 @@ public:
     }
     
     void drawIslandBoundaries(const Eigen::MatrixXd& V2D,
-                             const std::vector<UVSegmentation::UVIsland>& islands) {
+                             const UVSegmentation::IslandSet& islands) {
         std::vector<std::string> colors = {
             "#e74c3c", "#3498db", "#2ecc71", "#f39c12", "#9b59b6",
             "#1abc9c", "#e67e22", "#95a5a6", "#34495e", "#16a085"
         };
         
-        for (size_t i = 0; i < islands.size(); i++) {
-            const auto& island = islands[i];
+        for (int i = 0; i < islands.numIslands(); i++) {
             std::string color = colors[i % colors.size()];
             
-            // 绘制岛屿边界
-            for (const auto& edge : island.boundary) {
-                int v0 = edge.v0;
-                int v1 = edge.v1;
-                
-                Eigen::Vector2d p0 = V2D.row(v0);
-                Eigen::Vector2d p1 = V2D.row(v1);
-                
-                file_ << "<line x1=\"" << p0.x() << "\" y1=\"" << p0.y() << "\" ";
-                file_ << "x2=\"" << p1.x() << "\" y2=\"" << p1.y() << "\" ";
+            // 绘制岛屿边界环（有序的闭合顶点序列，直接画成多边形轮廓）
+            for (int k = 0; k < islands.numLoops(i); k++) {
+                file_ << "<polygon points=\"";
+                for (int v : islands.islandLoop(i, k)) {
+                    Eigen::Vector2d p = V2D.row(v);
+                    file_ << p.x() << "," << p.y() << " ";
+                }
+                file_ << "\" fill=\"none\" ";
                 file_ << "stroke=\"" << color << "\" stroke-width=\"2.5\" ";
-                file_ << "stroke-linecap=\"round\"/>\n";
+                file_ << "stroke-linejoin=\"round\"/>\n";
             }
         }
     }
@@ -129,73 +125,39 @@ Eigen::MatrixXd project_to_2d(const Eigen::MatrixXd& V) {
     return V2D;
 }
 
-// 从UV岛提取缝合线
-std::vector<std::pair<int, int>> extract_seams_from_islands(
-    const Eigen::MatrixXi& F,
-    const std::vector<UVSegmentation::UVIsland>& islands) {
-    
-    std::set<std::pair<int, int>> all_edges;
-    std::set<std::pair<int, int>> seam_edges;
-    
-    // 收集所有边
-    for (int i = 0; i < F.rows(); i++) {
-        for (int j = 0; j < 3; j++) {
-            int v0 = F(i, j);
-            int v1 = F(i, (j+1)%3);
-            if (v0 > v1) std::swap(v0, v1);
-            all_edges.insert({v0, v1});
-        }
-    }
-    
-    // 收集岛屿内部边
-    std::set<std::pair<int, int>> island_internal_edges;
-    for (const auto& island : islands) {
-        for (int face_idx : island.faces) {
-            for (int j = 0; j < 3; j++) {
-                int v0 = F(face_idx, j);
-                int v1 = F(face_idx, (j+1)%3);
-                if (v0 > v1) std::swap(v0, v1);
-                island_internal_edges.insert({v0, v1});
-            }
-        }
-    }
-    
-    // 缝合线 = 所有边 - 岛屿内部边
-    std::vector<std::pair<int, int>> seams;
-    for (const auto& edge : all_edges) {
-        if (island_internal_edges.find(edge) == island_internal_edges.end()) {
-            seams.push_back(edge);
-        }
-    }
-    
-    return seams;
-}
-
 void test_segmentation_method(const std::string& name,
                               const Eigen::MatrixXd& V,
                               const Eigen::MatrixXi& F,
-                              const std::vector<UVSegmentation::UVIsland>& islands,
+                              const UVSegmentation::MeshTopology& topo,
+                              const UVSegmentation::IslandSet& islands,
                               const std::string& output_file) {
     Eigen::MatrixXd V2D = project_to_2d(V);
+    const std::string num_islands = std::to_string(islands.numIslands());
+    
+    // 去重后的缝合线，每条只画一次
+    auto seams = UVSegmentation::buildSeamGraph(V, topo, islands);
     
     SeamVisualizer svg(output_file, 800, 800);
-    svg.drawTitle(name + " - Seam Lines (" + std::to_string(islands.size()) + " islands)");
+    svg.drawTitle(name + " - Seam Lines (" + num_islands + " islands)");
     
     // 绘制网格
     svg.drawMesh(V, F, V2D);
     
-    // 绘制UV岛边界（不同颜色）
+    // 绘制UV岛边界（不同颜色）和缝合线
     svg.drawIslandBoundaries(V2D, islands);
+    svg.drawSeams(V2D, seams);
     
     // 添加图例
     std::vector<std::string> legend_items = {
-        "UV Islands: " + std::to_string(islands.size()),
+        "UV Islands: " + num_islands,
+        "Seam Edges: " + std::to_string(seams.numSeams()),
         "Total Faces: " + std::to_string(F.rows())
     };
-    std::vector<std::string> legend_colors = {"#e74c3c", "#2c3e50"};
+    std::vector<std::string> legend_colors = {"#e74c3c", "#dc3545", "#2c3e50"};
     svg.drawLegend(legend_items, legend_colors);
     
-    std::cout << "✓ " << name << ": " << islands.size() << " UV岛\n";
+    std::cout << "✓ " << name << ": " << num_islands << " UV岛, "
+              << seams.numSeams() << " 条缝合边\n";
     std::cout << "  保存到: " << output_file << "\n";
 }
 
@@ -227,15 +189,17 @@ int main(int argc, char* argv[]) {
     
     using namespace UVSegmentation;
     
+    MeshTopology topo = buildMeshTopology(V, F);
+    
     // 测试不同的分割算法
     std::cout << "测试分割算法:\n";
     std::cout << "----------------------------------------\n";
     
     // 1. 边缘环分割
     try {
-        auto edge_loops = detectEdgeLoops(V, F, 30.0);
-        auto islands = segmentByEdgeLoops(V, F, edge_loops);
-        test_segmentation_method("Edge Loop", V, F, islands,
+        auto edge_loops = detectEdgeLoops(V, F, topo, 30.0);
+        auto islands = segmentByEdgeLoops(V, F, topo, edge_loops);
+        test_segmentation_method("Edge Loop", V, F, topo, islands,
                                 output_prefix + "_edgeloop.svg");
     } catch (const std::exception& e) {
         std::cout << "✗ Edge Loop failed: " << e.what() << "\n";
@@ -243,8 +207,8 @@ int main(int argc, char* argv[]) {
     
     // 2. 高曲率分割
     try {
-        auto islands = segmentByHighCurvature(V, F, 0.5);
-        test_segmentation_method("High Curvature", V, F, islands,
+        auto islands = segmentByHighCurvature(V, F, topo, 0.5);
+        test_segmentation_method("High Curvature", V, F, topo, islands,
                                 output_prefix + "_curvature.svg");
     } catch (const std::exception& e) {
         std::cout << "✗ High Curvature failed: " << e.what() << "\n";
@@ -252,8 +216,8 @@ int main(int argc, char* argv[]) {
     
     // 3. 高斯曲率分割
     try {
-        auto islands = segmentByGaussianCurvature(V, F, 0.01);
-        test_segmentation_method("Gaussian Curvature", V, F, islands,
+        auto islands = segmentByGaussianCurvature(V, F, topo, 0.01);
+        test_segmentation_method("Gaussian Curvature", V, F, topo, islands,
                                 output_prefix + "_gaussian.svg");
     } catch (const std::exception& e) {
         std::cout << "✗ Gaussian Curvature failed: " << e.what() << "\n";
@@ -262,8 +226,8 @@ int main(int argc, char* argv[]) {
     // 4. 对称分割（假设YZ平面对称）
     try {
         Eigen::Vector4d plane(1, 0, 0, 0); // x = 0平面
-        auto islands = segmentBySymmetry(V, F, plane, 0.01);
-        test_segmentation_method("Symmetry (YZ plane)", V, F, islands,
+        auto islands = segmentBySymmetry(V, F, topo, plane, 0.01);
+        test_segmentation_method("Symmetry (YZ plane)", V, F, topo, islands,
                                 output_prefix + "_symmetry.svg");
     } catch (const std::exception& e) {
         std::cout << "✗ Symmetry failed: " << e.what() << "\n";
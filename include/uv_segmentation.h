@@ -2,6 +2,10 @@
 
 #include <vector>
 #include <set>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <Eigen/Core>
 
 /**
@@ -13,29 +17,883 @@
 
 namespace UVSegmentation {
 
+/**
+ * @brief 半边 ID 与 CSR 偏移的整数类型
+ * 
+ * 半边数是面数的三倍，细分后的扫描网格可能超过 2^31。默认 32 位；
+ * 以 UV_SEGMENTATION_64BIT_HALFEDGES 编译（CMake 选项同名）时改为 64 位。
+ * 顶点、面和边 ID 始终为 int。
+ */
+#ifdef UV_SEGMENTATION_64BIT_HALFEDGES
+using HalfedgeIndex = int64_t;
+#else
+using HalfedgeIndex = int;
+#endif
+
+/**
+ * @brief 支持的最大顶点数与面数
+ * 
+ * 顶点、面和边 ID 为 int，半边 ID 3 * f + i 须能用 HalfedgeIndex 表示；
+ * MatrixXi64 面矩阵只放宽索引的存储类型，不提高这些上限。超出上限的网格：
+ * buildMeshTopology 返回空拓扑，validateMesh 报告 exceeds_index_limits，
+ * repairMesh、weldVertices 和 reorderMeshForLocality 输出空网格。
+ */
+constexpr int64_t kMaxVertices = std::numeric_limits<int>::max();
+constexpr int64_t kMaxFaces = std::min<int64_t>(std::numeric_limits<int>::max(),
+                                                std::numeric_limits<HalfedgeIndex>::max() / 3);
+
+/**
+ * @brief 顶点数和面数是否都在 kMaxVertices / kMaxFaces 以内
+ */
+inline bool withinIndexLimits(int64_t num_vertices, int64_t num_faces) {
+    return num_vertices <= kMaxVertices && num_faces <= kMaxFaces;
+}
+
+/**
+ * @brief 64 位索引的面矩阵
+ */
+using MatrixXi64 = Eigen::Matrix<int64_t, Eigen::Dynamic, Eigen::Dynamic>;
+
+/**
+ * @brief 与输入矩阵标量类型相同的输出矩阵
+ */
+template <typename Derived>
+using PlainMatrix = Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+
+/**
+ * @brief 外部顶点缓冲区的只读视图（float，行主序，相邻顶点相隔 stride 个 float）
+ * 
+ * 交错顶点格式（位置 + 法线 + UV ...）可直接传入，无需复制到 Eigen::MatrixXd。
+ */
+using VertexBufferView = Eigen::Map<
+    const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor>, 0, Eigen::OuterStride<>>;
+
+/**
+ * @brief 外部索引缓冲区的只读视图（uint32，紧密排列，每三个索引一个三角形）
+ */
+using IndexBufferView = Eigen::Map<
+    const Eigen::Matrix<uint32_t, Eigen::Dynamic, 3, Eigen::RowMajor>>;
+
+/**
+ * @brief 以 (指针, 顶点数, 步长) 构造顶点视图，步长以 float 个数计，至少为 3
+ */
+inline VertexBufferView viewVertexBuffer(const float* data, size_t num_vertices, size_t stride = 3) {
+    return VertexBufferView(data, num_vertices, 3, Eigen::OuterStride<>(stride));
+}
+
+/**
+ * @brief 以 (指针, 三角形数) 构造索引视图
+ */
+inline IndexBufferView viewIndexBuffer(const uint32_t* data, size_t num_faces) {
+    return IndexBufferView(data, num_faces, 3);
+}
+
+/*
+ * 接受 (V, F) 的函数都以 Eigen::MatrixBase 为参数（与 libigl 相同的约定），
+ * 库内为以下组合显式实例化：
+ *   Eigen::MatrixXf + Eigen::MatrixXi           float 顶点，减半顶点数据带宽
+ *   Eigen::MatrixXd + Eigen::MatrixXi
+ *   Eigen::MatrixXd + MatrixXi64                 64 位索引输入
+ *   VertexBufferView + IndexBufferView           直接读取宿主程序的缓冲区
+ * 几何计算内部统一使用 double。输出矩阵（V_out/F_out）总是自有的 PlainMatrix。
+ */
+
 /**
  * @brief 表示一个边的结构
  */
 struct Edge {
     int v0, v1;  // 顶点索引
     
+    Edge() : v0(-1), v1(-1) {}
     Edge(int a, int b) : v0(std::min(a, b)), v1(std::max(a, b)) {}
     
     bool operator<(const Edge& other) const {
         return v0 < other.v0 || (v0 == other.v0 && v1 < other.v1);
     }
+    
+    bool operator==(const Edge& other) const {
+        return v0 == other.v0 && v1 == other.v1;
+    }
+    
+    // 打包为 64 位键 (v0 在高 32 位)，用于哈希和排序
+    uint64_t key() const {
+        return (uint64_t(uint32_t(v0)) << 32) | uint32_t(v1);
+    }
 };
 
 /**
  * @brief UV 岛结构
  */
 struct UVIsland {
-    std::vector<int> faces;        // 面索引
-    std::vector<Edge> boundary;    // 边界边
-    Eigen::Vector3d centroid;      // 质心
-    double area;                   // 面积
+    std::vector<int> faces;                     // 面索引
+    std::vector<Edge> boundary;                 // 边界边（岛内的切割边，无序）
+    std::vector<std::vector<int>> boundary_loops;  // 有序边界环（顶点序列），外环在前
+    Eigen::Vector3d centroid;                   // 质心
+    double area;                                // 面积
+};
+
+/**
+ * @brief 连续内存上的只读区间
+ */
+template <typename T>
+class ConstSpan {
+public:
+    ConstSpan(const T* first, const T* last) : first_(first), last_(last) {}
+    
+    const T* begin() const { return first_; }
+    const T* end() const { return last_; }
+    size_t size() const { return static_cast<size_t>(last_ - first_); }
+    bool empty() const { return first_ == last_; }
+    const T& operator[](size_t i) const { return first_[i]; }
+    
+private:
+    const T* first_;
+    const T* last_;
+};
+
+/**
+ * @brief 按边 ID 索引的位集合
+ * 
+ * 与 MeshTopology 的边编号配合使用，用于标记切割边等逐边标志，
+ * 查询只需一次位运算。
+ */
+class EdgeMask {
+public:
+    EdgeMask() = default;
+    explicit EdgeMask(int num_edges)
+        : size_(num_edges), words_((num_edges + 63) / 64, 0) {}
+    
+    int size() const { return size_; }
+    
+    bool test(int e) const { return (words_[e >> 6] >> (e & 63)) & 1; }
+    void set(int e) { words_[e >> 6] |= uint64_t(1) << (e & 63); }
+    void reset(int e) { words_[e >> 6] &= ~(uint64_t(1) << (e & 63)); }
+    
+    bool any() const {
+        for (uint64_t w : words_) if (w) return true;
+        return false;
+    }
+    
+    int count() const {
+        int n = 0;
+        for (uint64_t w : words_) {
+            for (; w; w &= w - 1) ++n;
+        }
+        return n;
+    }
+    
+    // 按 64 位字访问，便于并行按字写入
+    uint64_t& word(int i) { return words_[i]; }
+    uint64_t word(int i) const { return words_[i]; }
+    int numWords() const { return static_cast<int>(words_.size()); }
+    
+private:
+    int size_ = 0;
+    std::vector<uint64_t> words_;
+};
+
+/**
+ * @brief 紧凑的分割结果
+ * 
+ * 所有岛共用一个面标签数组和若干 CSR（面、边界边、边界环），不再为每个岛单独分配。
+ * 岛按最小面索引升序编号（segmentByDetailIsolation 例外：0 为细节岛）。
+ * 需要逐岛对象时用 toUVIslands 转换。
+ * 
+ * 边界环是闭合的顶点序列（首尾不重复），沿岛的面的半边方向走，岛在左侧：
+ * 外环与面法向成逆时针，洞为顺时针。岛的边界包括网格边界、与其他岛相邻的边
+ * 和岛内部的切割边（切缝两侧各走一次）。每个岛最长（三维长度）的环为外环，
+ * 排在最前；其余环按发现顺序排列。非流形边和朝向不一致的边也按边界处理。
+ * 
+ * 岛邻接图是对称的 CSR：两个岛共享至少一条边即相邻，附带共享边数和缝合线长度；
+ * 每行按邻岛 ID 升序，岛内切缝不计入。邻接图需要额外遍历一次所有边，只在
+ * SegmentationOptions::island_adjacency 为 true 时填写，否则四个数组均为空。
+ * 
+ * cut_edges 是分割时的切割边位集合（边 ID 以分割所用的拓扑为准），供 buildSeamGraph
+ * 直接复用；由 UVIsland 重建或经 restoreOriginalIndices 换回原编号后为空。
+ */
+struct IslandSet {
+    std::vector<int> face_island;                  // 面 -> 岛 ID (F)
+    std::vector<int> face_offsets;                 // 岛 -> 面 CSR 偏移 (岛数 + 1)
+    std::vector<int> faces;                        // 岛 -> 面 CSR 数据
+    std::vector<HalfedgeIndex> boundary_offsets;   // 岛 -> 边界边 CSR 偏移 (岛数 + 1)
+    std::vector<Edge> boundary;                    // 岛 -> 边界边 CSR 数据
+    std::vector<int> island_loop_offsets;          // 岛 -> 边界环 CSR 偏移 (岛数 + 1)
+    std::vector<HalfedgeIndex> loop_offsets;       // 边界环 -> 顶点 CSR 偏移 (环数 + 1)
+    std::vector<int> loop_vertices;                // 边界环 -> 顶点 CSR 数据
+    std::vector<Eigen::Vector3d> centroids;        // 岛的面积加权质心
+    std::vector<double> areas;                     // 岛的面积
+    std::vector<int> neighbor_offsets;             // 岛 -> 邻岛 CSR 偏移 (岛数 + 1)
+    std::vector<int> neighbors;                    // 岛 -> 邻岛 CSR 数据
+    std::vector<int> shared_edges;                 // 与对应邻岛共享的边数
+    std::vector<double> shared_lengths;            // 与对应邻岛共享的缝合线长度
+    EdgeMask cut_edges;                            // 切割边 (边数，可能为空)
+    
+    int numIslands() const {
+        return face_offsets.empty() ? 0 : static_cast<int>(face_offsets.size()) - 1;
+    }
+    
+    bool hasAdjacency() const { return static_cast<int>(neighbor_offsets.size()) == numIslands() + 1; }
+    
+    ConstSpan<int> islandFaces(int i) const {
+        return {faces.data() + face_offsets[i], faces.data() + face_offsets[i + 1]};
+    }
+    
+    ConstSpan<Edge> islandBoundary(int i) const {
+        return {boundary.data() + boundary_offsets[i], boundary.data() + boundary_offsets[i + 1]};
+    }
+    
+    ConstSpan<int> islandNeighbors(int i) const {
+        return {neighbors.data() + neighbor_offsets[i], neighbors.data() + neighbor_offsets[i + 1]};
+    }
+    
+    int numLoops(int i) const { return island_loop_offsets[i + 1] - island_loop_offsets[i]; }
+    
+    // 岛 i 的第 k 个边界环（k = 0 为外环）
+    ConstSpan<int> islandLoop(int i, int k) const {
+        const int loop = island_loop_offsets[i] + k;
+        return {loop_vertices.data() + loop_offsets[loop], loop_vertices.data() + loop_offsets[loop + 1]};
+    }
+};
+
+/**
+ * @brief 由特征边串联成的有序链
+ * 
+ * edges[i] 连接 vertices[i] 与 vertices[i + 1]；闭合环首尾顶点不重复，
+ * 最后一条边回到 vertices[0]，因此 edges.size() == vertices.size()，
+ * 开放折线则少一条。边 ID 以检测时使用的 MeshTopology 为准。
+ */
+struct EdgeLoop {
+    std::vector<int> vertices;   // 有序顶点
+    std::vector<int> edges;      // 相邻顶点之间的边 ID
+    bool closed = false;         // 闭合环还是开放折线
+};
+
+/**
+ * @brief 流式分割时交给回调的岛
+ * 
+ * faces/boundary 指向内部复用的缓冲区，只在回调期间有效，需要保留时自行复制。
+ */
+struct IslandView {
+    int id;                      // 岛 ID（按最小面索引升序，与 IslandSet 一致）
+    ConstSpan<int> faces;        // 面索引（BFS 顺序）
+    ConstSpan<Edge> boundary;    // 岛内的切割边
+    Eigen::Vector3d centroid;    // 面积加权质心
+    double area;                 // 面积
+    Eigen::Vector3d bbox_min;    // 包围盒最小角
+    Eigen::Vector3d bbox_max;    // 包围盒最大角
+};
+
+/**
+ * @brief 每个岛完成洪泛后立即调用的回调
+ */
+using IslandVisitor = std::function<void(const IslandView&)>;
+
+/**
+ * @brief 全局缝合线图：每条缝合边恰好出现一次
+ * 
+ * 缝合边是两侧面属于不同岛的边，或岛内部的切割边（切缝）；网格边界不算缝合线。
+ * 各数组按下标一一对应，按边 ID 升序排列。left_island 为沿 v0 -> v1 方向
+ * 左侧的面（即含半边 v0 -> v1 的面）所在的岛。
+ */
+struct SeamGraph {
+    std::vector<int> edge_ids;        // 缝合边在 MeshTopology 中的边 ID
+    std::vector<Edge> edges;          // 缝合边的顶点对
+    std::vector<int> left_island;     // 左侧岛
+    std::vector<int> right_island;    // 右侧岛（切缝时与 left_island 相同）
+    std::vector<double> lengths;      // 边长
+    
+    int numSeams() const { return static_cast<int>(edge_ids.size()); }
+};
+
+/**
+ * @brief 岛合并树（Kruskal 式的分量层次）
+ * 
+ * 按边的切割权重升序合并面，每次合并两个分量新建一个节点。阈值 t 下的岛就是
+ * 只沿权重 <= t 的边合并得到的分量，即切开所有权重 > t 的边后的结果。
+ * 节点 [0, num_faces) 为面，其后为合并节点，合并节点的编号与权重都随合并顺序递增。
+ */
+struct IslandMergeTree {
+    int num_faces = 0;
+    std::vector<double> edge_weights;    // 边 -> 切割权重
+    std::vector<int> parent;             // 节点 -> 父节点（根为 -1）
+    std::vector<double> merge_weights;   // 合并节点 -> 合并时的权重（非降）
+    std::vector<int> min_face;           // 合并节点 -> 子树中最小的面
+    
+    int numMerges() const { return static_cast<int>(merge_weights.size()); }
+};
+
+/**
+ * @brief 将 IslandSet 展开为逐岛的 UVIsland（便于遍历，但每个岛各自分配）
+ */
+std::vector<UVIsland> toUVIslands(const IslandSet& islands);
+
+/**
+ * @brief 半边网格（结构数组布局）
+ * 
+ * 三角形 f 的三条内部半边为 3f, 3f+1, 3f+2，第 i 条从 F(f,i) 指向
+ * F(f,(i+1)%3)。边界半边追加在内部半边之后，face 为 -1，并沿网格
+ * 边界首尾相连。非流形边或朝向不一致的边按边界处理，因此每条半边
+ * 都有 twin。
+ */
+struct HalfEdgeMesh {
+    std::vector<HalfedgeIndex> next;             // 下一条半边
+    std::vector<HalfedgeIndex> twin;             // 对偶半边
+    std::vector<int> vertex;                     // 起点顶点
+    std::vector<int> face;                       // 所在面（边界半边为 -1）
+    std::vector<int> edge;                       // 对应 MeshTopology 的边 ID
+    std::vector<HalfedgeIndex> vertex_halfedge;  // 每个顶点的一条出半边（边界顶点取边界出半边，孤立顶点为 -1）
+    
+    HalfedgeIndex numHalfedges() const { return static_cast<HalfedgeIndex>(next.size()); }
+    int tip(HalfedgeIndex h) const { return vertex[next[h]]; }
+    bool isBoundary(HalfedgeIndex h) const { return face[h] < 0; }
+    
+    /**
+     * @brief 半边循环器：从起始半边出发反复前进一步，回到起点时结束
+     */
+    class Circulator {
+    public:
+        class Iterator {
+        public:
+            Iterator(const HalfEdgeMesh* mesh, HalfedgeIndex start, HalfedgeIndex current, bool rotate)
+                : mesh_(mesh), start_(start), current_(current), rotate_(rotate) {}
+            
+            HalfedgeIndex operator*() const { return current_; }
+            
+            Iterator& operator++() {
+                current_ = rotate_ ? mesh_->next[mesh_->twin[current_]]
+                                   : mesh_->next[current_];
+                if (current_ == start_) current_ = -1;
+                return *this;
+            }
+            
+            bool operator!=(const Iterator& other) const { return current_ != other.current_; }
+            
+        private:
+            const HalfEdgeMesh* mesh_;
+            HalfedgeIndex start_;
+            HalfedgeIndex current_;
+            bool rotate_;
+        };
+        
+        Circulator(const HalfEdgeMesh* mesh, HalfedgeIndex start, bool rotate)
+            : mesh_(mesh), start_(start), rotate_(rotate) {}
+        
+        Iterator begin() const { return Iterator(mesh_, start_, start_, rotate_); }
+        Iterator end() const { return Iterator(mesh_, start_, -1, rotate_); }
+        
+    private:
+        const HalfEdgeMesh* mesh_;
+        HalfedgeIndex start_;
+        bool rotate_;
+    };
+    
+    /**
+     * @brief 顶点一环的出半边（非流形顶点只遍历 vertex_halfedge 所在的扇区）
+     */
+    Circulator outgoing(int v) const { return Circulator(this, vertex_halfedge[v], true); }
+    
+    /**
+     * @brief 面的三条半边
+     */
+    Circulator faceHalfedges(int f) const { return Circulator(this, HalfedgeIndex(3) * f, false); }
+    
+    /**
+     * @brief 从边界半边 h 出发沿边界环行走
+     */
+    Circulator boundaryLoop(HalfedgeIndex h) const { return Circulator(this, h, false); }
+};
+
+/**
+ * @brief 网格拓扑（边编号、边-面、面-边、顶点-边）
+ * 
+ * 由 buildMeshTopology 构建一次后可被所有分割算法复用，
+ * 避免每个算法各自重建边到面的映射。变长关系均以 CSR
+ * （偏移数组 + 数据数组）形式存储。
+ */
+struct MeshTopology {
+    static constexpr int kNoNeighbor = -1;   // 边界边
+    static constexpr int kNonManifold = -2;  // 多于两个面共享，需查 edge_faces
+    
+    int num_vertices = 0;
+    int num_faces = 0;
+    
+    std::vector<Edge> edges;                         // 边 ID -> 顶点对
+    std::vector<HalfedgeIndex> edge_face_offsets;    // 边 -> 面 CSR 偏移 (E + 1)
+    std::vector<int> edge_faces;                     // 边 -> 面 CSR 数据
+    std::vector<int> face_edges;                     // 面 -> 边 (F x 3)，第 i 条为 (F(f,i), F(f,(i+1)%3))
+    std::vector<int> face_neighbors;                 // 面 -> 第 i 条边对面的相邻面 (F x 3)，见 kNoNeighbor/kNonManifold
+    std::vector<HalfedgeIndex> vertex_edge_offsets;  // 顶点 -> 边 CSR 偏移 (V + 1)
+    std::vector<int> vertex_edges;                   // 顶点 -> 边 CSR 数据
+    HalfEdgeMesh halfedges;                          // 半边结构，边 ID 与上面一致
+    
+    int numEdges() const { return static_cast<int>(edges.size()); }
+    
+    // 面 f 的第 i 个角（即内部半边 3f+i）
+    static HalfedgeIndex corner(int f, int i) { return HalfedgeIndex(3) * f + i; }
+    
+    int faceEdge(int f, int i) const { return face_edges[corner(f, i)]; }
+    
+    int faceNeighbor(int f, int i) const { return face_neighbors[corner(f, i)]; }
+    
+    int edgeFaceCount(int e) const {
+        return static_cast<int>(edge_face_offsets[e + 1] - edge_face_offsets[e]);
+    }
+    
+    /**
+     * @brief 查找顶点对 (a, b) 对应的边 ID，不存在时返回 -1
+     */
+    int findEdge(int a, int b) const;
+};
+
+/**
+ * @brief 构建网格拓扑
+ * 
+ * @param V 顶点矩阵
+ * @param F 面矩阵（顶点索引必须在 [0, V.rows()) 范围内）
+ * @return 网格拓扑（超出 kMaxVertices / kMaxFaces 或边数超出 int 时为空拓扑）
+ */
+template <typename DerivedV, typename DerivedF>
+MeshTopology buildMeshTopology(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F
+);
+
+/**
+ * @brief 构建半边网格
+ * 
+ * 已有 MeshTopology 时直接使用其 halfedges 成员即可。
+ * 
+ * @param V 顶点矩阵
+ * @param F 面矩阵
+ * @return 半边网格
+ */
+template <typename DerivedV, typename DerivedF>
+HalfEdgeMesh buildHalfEdgeMesh(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F
+);
+
+/**
+ * @brief 逐面 / 逐边几何量缓存（结构数组布局，每个分量一段连续内存）
+ * 
+ * 由 buildGeometryCache 一趟并行扫描所有面得到法向、面积和重心，再并行计算边长。
+ * 只依赖顶点位置：拓扑不变时可被多次分割调用复用，V 改变后重新构建即可。
+ */
+struct GeometryCache {
+    Eigen::Matrix<double, Eigen::Dynamic, 3> normals;      // 单位法向 (F x 3，按列存储；退化面为零向量)
+    Eigen::VectorXd areas;                                 // 面积 (F)
+    Eigen::Matrix<double, Eigen::Dynamic, 3> barycenters;  // 重心 (F x 3，按列存储)
+    std::vector<double> edge_lengths;                      // 边长，按 MeshTopology 的边 ID
+    
+    int numFaces() const { return static_cast<int>(areas.size()); }
+};
+
+/**
+ * @brief 构建几何缓存
+ * 
+ * 面按固定大小分块并行；块内先把三个角的坐标收集成按分量连续的数组，
+ * 叉积、模长和重心都以逐元素的 Eigen 数组表达式计算，可被编译器向量化。
+ * 
+ * @param V 顶点矩阵
+ * @param F 面矩阵
+ * @param topo 网格拓扑（提供边 ID）
+ * @return 几何缓存
+ */
+template <typename DerivedV, typename DerivedF>
+GeometryCache buildGeometryCache(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo
+);
+
+/**
+ * @brief 多边形网格（四边形 / n 边形面，CSR 存储）
+ * 
+ * 面 f 的顶点为 face_vertices[face_offsets[f] .. face_offsets[f + 1])，
+ * 按逆时针排列。少于三个顶点的面不产生三角形。
+ */
+struct PolygonMesh {
+    std::vector<HalfedgeIndex> face_offsets{0};  // 面 -> 顶点 CSR 偏移 (面数 + 1)
+    std::vector<int> face_vertices;              // 面 -> 顶点 CSR 数据
+    
+    int numFaces() const { return static_cast<int>(face_offsets.size()) - 1; }
+    
+    int faceSize(int f) const { return static_cast<int>(face_offsets[f + 1] - face_offsets[f]); }
+    
+    ConstSpan<int> faceVertices(int f) const {
+        return {face_vertices.data() + face_offsets[f], face_vertices.data() + face_offsets[f + 1]};
+    }
+    
+    void addFace(const std::vector<int>& vertices) {
+        face_vertices.insert(face_vertices.end(), vertices.begin(), vertices.end());
+        face_offsets.push_back(static_cast<HalfedgeIndex>(face_vertices.size()));
+    }
+};
+
+/**
+ * @brief 三角化后的多边形网格
+ * 
+ * 分割算法在 (V, F, topo) 上运行，得到的岛以三角形为单位；只切割多边形边时，
+ * 同一多边形的三角形总在同一个岛内，可用 triangle_offsets 映射回多边形。
+ */
+struct TriangulatedPolygonMesh {
+    Eigen::MatrixXi F;                   // 扇形三角化得到的三角形
+    std::vector<int> triangle_offsets;   // 多边形 -> 三角形区间 (多边形数 + 1)
+    std::vector<int> triangle_polygon;   // 三角形 -> 所属多边形
+    MeshTopology topo;                   // 三角网格拓扑
+    EdgeMask polygon_edges;              // 多边形的边（不含三角化对角线），按 topo 的边 ID
+};
+
+/**
+ * @brief 多边形网格扇形三角化并构建拓扑
+ * 
+ * 每个 n 边形以第一个顶点为扇心拆成 n - 2 个三角形，三角形按多边形顺序连续编号，
+ * 各多边形的三角形区间由面大小直接得出，并行写入。
+ * 
+ * @param V 顶点矩阵
+ * @param polygons 多边形网格
+ * @return 三角形、多边形映射、拓扑和多边形边集合
+ */
+template <typename DerivedV>
+TriangulatedPolygonMesh triangulatePolygonMesh(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const PolygonMesh& polygons
+);
+
+/**
+ * @brief 网格重排结果：新旧顶点/面索引的双向映射
+ */
+struct MeshReordering {
+    std::vector<int> vertex_new_to_old;
+    std::vector<int> vertex_old_to_new;
+    std::vector<int> face_new_to_old;
+    std::vector<int> face_old_to_new;
+};
+
+/**
+ * @brief 按空间填充曲线重排网格以提升缓存局部性
+ * 
+ * 面按重心的 Morton 码（Z 序）排序，顶点按在重排后面序列中首次
+ * 出现的顺序编号（未被引用的顶点排在最后）。重排后的 (V_out, F_out)
+ * 可直接传给本文件中的任意函数，结果再用 restoreOriginalIndices
+ * 映射回原始索引。
+ * 
+ * @param V 顶点矩阵
+ * @param F 面矩阵
+ * @param V_out 重排后的顶点矩阵
+ * @param F_out 重排后的面矩阵
+ * @return 新旧索引映射
+ */
+template <typename DerivedV, typename DerivedF>
+MeshReordering reorderMeshForLocality(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    PlainMatrix<DerivedV>& V_out,
+    PlainMatrix<DerivedF>& F_out
+);
+
+/**
+ * @brief 将重排网格上得到的 UV 岛（faces/boundary/boundary_loops）映射回原始索引
+ * 
+ * 只替换索引，不重新排序：岛的编号和岛内面的顺序仍沿用重排网格上的结果，
+ * 不再按原始面索引升序。
+ */
+void restoreOriginalIndices(
+    const MeshReordering& reordering,
+    std::vector<UVIsland>& islands
+);
+
+/**
+ * @brief 将重排网格上得到的 IslandSet 映射回原始索引
+ * 
+ * face_island、faces、boundary 和 loop_vertices 都换成原始索引；岛的编号和
+ * 岛内面的顺序不变，因此不再按原始面索引升序。
+ */
+void restoreOriginalIndices(
+    const MeshReordering& reordering,
+    IslandSet& islands
+);
+
+/**
+ * @brief 顶点焊接结果
+ */
+struct WeldResult {
+    std::vector<int> vertex_remap;     // 原顶点 -> 焊接后顶点
+    std::vector<int> face_new_to_old;  // 焊接后面 -> 原面（退化面被移除）
+    int num_merged = 0;                // 被合并掉的顶点数
+    int num_degenerate_faces = 0;      // 焊接后退化而移除的面数
+};
+
+/**
+ * @brief 合并距离在容差内的重合顶点
+ * 
+ * 按法线/UV 拆分导出的 OBJ 读入后是互不相连的三角形，分割前应先焊接。
+ * 使用并行空间哈希网格（单元边长不小于 tolerance）查找候选点对，
+ * 再以并查集求传递闭包；每组保留索引最小的顶点及其位置，焊接后
+ * 顶点按该索引升序编号，结果与线程数无关。
+ * 
+ * @param V 顶点矩阵
+ * @param F 面矩阵
+ * @param tolerance 焊接距离容差（<= 0 表示只合并完全重合的点）
+ * @param V_out 焊接后的顶点矩阵
+ * @param F_out 焊接后的面矩阵
+ * @return 顶点/面映射与统计
+ */
+template <typename DerivedV, typename DerivedF>
+WeldResult weldVertices(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    double tolerance,
+    PlainMatrix<DerivedV>& V_out,
+    PlainMatrix<DerivedF>& F_out
+);
+
+/**
+ * @brief 网格检查结果（各项为出错的面/边/顶点个数）
+ * 
+ * 非流形边和非流形顶点在剔除越界、退化和重复面之后统计。
+ */
+struct MeshValidationReport {
+    int out_of_range_faces = 0;     // 顶点索引越界的面
+    int degenerate_faces = 0;       // 顶点重复或面积为零的面
+    int duplicate_faces = 0;        // 顶点集合与更早的面相同
+    int non_manifold_edges = 0;     // 被三个及以上面共享的边
+    int non_manifold_vertices = 0;  // 一环由多个互不相连的扇区组成（领结顶点）
+    bool exceeds_index_limits = false;  // 顶点数或面数超出 kMaxVertices / kMaxFaces，其余各项未检查
+    
+    bool isValid() const {
+        return !exceeds_index_limits && out_of_range_faces == 0 && degenerate_faces == 0 && duplicate_faces == 0 &&
+               non_manifold_edges == 0 && non_manifold_vertices == 0;
+    }
+};
+
+/**
+ * @brief 网格修复选项
+ */
+struct MeshRepairOptions {
+    double area_epsilon = 0.0;                 // 面积不大于该值视为退化
+    bool drop_degenerate_faces = true;         // 移除退化面
+    bool drop_duplicate_faces = true;          // 移除重复面（保留索引最小的一个）
+    bool drop_non_manifold_faces = false;      // 非流形边上只保留索引最小的两个面
+    bool split_non_manifold_vertices = true;   // 按扇区复制非流形顶点
+};
+
+/**
+ * @brief 网格修复结果
+ */
+struct MeshRepairResult {
+    MeshValidationReport report;               // 修复前的检查结果
+    std::vector<int> face_new_to_old;          // 修复后面 -> 原面
+    std::vector<int> vertex_new_to_old;        // 修复后顶点 -> 原顶点（拆分出的副本排在最后）
+};
+
+/**
+ * @brief 检查网格的越界索引、退化面、重复面和非流形边/顶点
+ * 
+ * 线性时间，主要步骤并行。分割函数假定输入已通过检查，
+ * 不再逐次做防御性判断；来源不可靠的网格应先调用本函数或 repairMesh。
+ * 
+ * @param V 顶点矩阵
+ * @param F 面矩阵
+ * @param area_epsilon 面积不大于该值视为退化
+ * @return 检查结果
+ */
+template <typename DerivedV, typename DerivedF>
+MeshValidationReport validateMesh(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    double area_epsilon = 0.0
+);
+
+/**
+ * @brief 修复网格：移除问题面并拆分非流形顶点
+ * 
+ * 越界面总是移除，其余按 options 处理。拆分时每个非流形顶点的第一个扇区
+ * （含最小面索引）保留原顶点，其余扇区各得到一个追加在末尾的副本；
+ * 大多数非流形边也随之变为边界边。
+ * 
+ * @param V 顶点矩阵
+ * @param F 面矩阵
+ * @param V_out 修复后的顶点矩阵
+ * @param F_out 修复后的面矩阵
+ * @param options 修复选项
+ * @return 修复前的检查结果与新旧索引映射
+ */
+template <typename DerivedV, typename DerivedF>
+MeshRepairResult repairMesh(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    PlainMatrix<DerivedV>& V_out,
+    PlainMatrix<DerivedF>& F_out,
+    const MeshRepairOptions& options = MeshRepairOptions()
+);
+
+/**
+ * @brief 从分割结果提取去重后的缝合线图
+ * 
+ * 可用于任何返回 IslandSet 的分割函数，topo 须是分割时使用的拓扑。
+ * 切割边直接取自 islands.cut_edges，为空时才从边界边逐条查回边 ID。
+ * 
+ * @param V 顶点矩阵（用于边长）
+ * @param topo 网格拓扑
+ * @param islands 分割结果
+ * @param geometry 预先构建的几何缓存，给出时边长取自缓存
+ * @return 每条缝合边一项的扁平数组
+ */
+template <typename DerivedV>
+SeamGraph buildSeamGraph(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const MeshTopology& topo,
+    const IslandSet& islands,
+    const GeometryCache* geometry = nullptr
+);
+
+/**
+ * @brief 切割后划分 UV 岛（连通分量）所用的算法
+ * 
+ * 两种算法的输出完全相同，与线程数无关：岛按其最小面索引升序编号，
+ * 岛内面按索引升序排列，边界边按所在面的顺序排列。
+ */
+enum class IslandLabeling {
+    Automatic,      // 大网格且有多个线程时用 UnionFind，否则用 BreadthFirst
+    BreadthFirst,   // 串行 BFS
+    UnionFind       // 并行无锁并查集
 };
 
+/**
+ * @brief 分割选项
+ */
+struct SegmentationOptions {
+    IslandLabeling labeling = IslandLabeling::Automatic;
+    const GeometryCache* geometry = nullptr;  // 预先构建的几何缓存，为空时按需计算面积、质心和边长
+    bool island_adjacency = false;            // 同时构建岛邻接图（IslandSet::neighbors 等）
+};
+
+/**
+ * @brief 合并过小的岛（后处理）
+ * 
+ * 面积小于 min_area 或面数少于 min_faces 的岛并入与其共享缝合线最长的邻岛：
+ * 在岛邻接图上用面积最小堆从最小的岛开始贪心合并，岛标签用并查集维护，
+ * 合并后仍过小的岛继续参与，代价 O(E log I)。没有邻岛的岛保持不变。
+ * 合并后的岛按成员中最小的原岛 ID 排序，边界环和统计量重新计算。
+ * islands 没有邻接图时先行构建；结果的邻接图按 options.island_adjacency 填写。
+ * 
+ * @param topo 分割时使用的网格拓扑
+ * @param islands 分割结果
+ * @param min_area 面积阈值
+ * @param min_faces 面数阈值
+ * @return 合并后的分割结果
+ */
+template <typename DerivedV, typename DerivedF>
+IslandSet mergeSmallIslands(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const IslandSet& islands,
+    double min_area,
+    int min_faces = 0,
+    const SegmentationOptions& options = SegmentationOptions()
+);
+
+/**
+ * @brief 合并过小的岛（UVIsland 列表）
+ * 
+ * islands 须恰好覆盖 [0, F.rows()) 中的每个面一次；面 ID 越界、重复或有面未被覆盖时原样返回。
+ */
+template <typename DerivedV, typename DerivedF>
+std::vector<UVIsland> mergeSmallIslands(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const std::vector<UVIsland>& islands,
+    double min_area,
+    int min_faces = 0
+);
+
+/**
+ * @brief 由边的切割权重构建岛合并树
+ * 
+ * 权重只需计算一次（如 computeHighCurvatureEdgeWeights、computeFeatureAngleEdgeWeights），
+ * 之后用 islandsAtThreshold 查询任意阈值下的岛，无需重新计算曲率或拓扑。
+ * 边按权重做一次并行基数排序，合并为 O(E α(F))。
+ * 
+ * @param topo 网格拓扑
+ * @param edge_weights 每条边的权重（大小为 topo.numEdges()，不得为 NaN）
+ * @return 合并树
+ */
+IslandMergeTree buildIslandMergeTree(
+    const MeshTopology& topo,
+    const std::vector<double>& edge_weights
+);
+
+/**
+ * @brief 只查询阈值下每个面的岛 ID（O(面数)，用于滑块拖动时的实时预览）
+ * 
+ * 与 islandsAtThreshold 结果的 face_island 相同。
+ */
+std::vector<int> faceIslandsAtThreshold(
+    const IslandMergeTree& tree,
+    double threshold
+);
+
+/**
+ * @brief 查询阈值下的岛（切开权重 > threshold 的边）
+ * 
+ * 结果与 segmentByCutEdges 对同一切割集合的结果相同（岛内面按索引升序）。
+ * 分量由合并树在 O(面数) 内得到，其余为 CSR、边界环、统计量（及按需的邻接图）的构建。
+ */
+template <typename DerivedV, typename DerivedF>
+IslandSet islandsAtThreshold(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const IslandMergeTree& tree,
+    double threshold,
+    const SegmentationOptions& options = SegmentationOptions()
+);
+
+/**
+ * @brief 按切割边分割网格
+ * 
+ * 所有分割算法最终都归结到这里：切割边两侧的面分属不同岛（或同一岛的切缝两侧）。
+ * 没有切割边时每个连通分量为一个岛。
+ * 
+ * @param topo 网格拓扑（边 ID 以此为准）
+ * @param cut_edges 按边 ID 的切割位集合，大小须为 topo.numEdges()
+ * @return 紧凑的 IslandSet
+ */
+template <typename DerivedV, typename DerivedF>
+IslandSet segmentByCutEdges(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const EdgeMask& cut_edges,
+    const SegmentationOptions& options = SegmentationOptions()
+);
+
+/**
+ * @brief 按切割边 ID 列表分割网格（越界的 ID 直接忽略）
+ */
+template <typename DerivedV, typename DerivedF>
+IslandSet segmentByCutEdges(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const std::vector<int>& cut_edge_ids,
+    const SegmentationOptions& options = SegmentationOptions()
+);
+
+/**
+ * @brief 按切割边分割网格，逐岛流式交给回调（见 segmentByEdgeLoops 的回调重载）
+ */
+template <typename DerivedV, typename DerivedF>
+void segmentByCutEdges(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const EdgeMask& cut_edges,
+    const IslandVisitor& visitor
+);
+
 /**
  * @brief 按拓扑环（Edge Loop）分割网格
  * 
@@ -50,26 +908,280 @@ struct UVIsland {
  * @param edge_loops 预定义的边环列表
  * @return UV 岛列表
  */
+template <typename DerivedV, typename DerivedF>
 std::vector<UVIsland> segmentByEdgeLoops(
-    const Eigen::MatrixXd& V,
-    const Eigen::MatrixXi& F,
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
     const std::vector<std::vector<int>>& edge_loops
 );
 
+/**
+ * @brief 按拓扑环分割网格（复用预先构建的拓扑，返回紧凑的 IslandSet）
+ * 
+ * 环上相邻顶点对应的网格边即为切割边，其余同 segmentByCutEdges。
+ */
+template <typename DerivedV, typename DerivedF>
+IslandSet segmentByEdgeLoops(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const std::vector<std::vector<int>>& edge_loops,
+    const SegmentationOptions& options = SegmentationOptions()
+);
+
+/**
+ * @brief 按拓扑环分割网格，逐岛流式交给回调
+ * 
+ * 不保存全部岛：每个岛完成 BFS 后立即调用 visitor，面和边界边缓冲区在岛之间复用，
+ * 除 O(面数) 的访问标记外，峰值内存只与最大的岛成正比。总是串行 BFS。
+ * 
+ * @param visitor 对每个岛按 ID 升序调用一次
+ */
+template <typename DerivedV, typename DerivedF>
+void segmentByEdgeLoops(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const std::vector<std::vector<int>>& edge_loops,
+    const IslandVisitor& visitor
+);
+
+/**
+ * @brief 按检测到的边环分割网格（直接使用 EdgeLoop 中的边 ID）
+ * 
+ * edge_loops 须来自同一 (V, F)：此重载内部重新构建的拓扑与检测时的边编号相同。
+ */
+template <typename DerivedV, typename DerivedF>
+std::vector<UVIsland> segmentByEdgeLoops(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const std::vector<EdgeLoop>& edge_loops
+);
+
+/**
+ * @brief 按检测到的边环分割网格（复用预先构建的拓扑，返回紧凑的 IslandSet）
+ * 
+ * 边 ID 须以 topo 为准，如 detectEdgeLoops(V, F, topo) 的结果。
+ */
+template <typename DerivedV, typename DerivedF>
+IslandSet segmentByEdgeLoops(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const std::vector<EdgeLoop>& edge_loops,
+    const SegmentationOptions& options = SegmentationOptions()
+);
+
+/**
+ * @brief 按检测到的边环分割网格，逐岛流式交给回调
+ */
+template <typename DerivedV, typename DerivedF>
+void segmentByEdgeLoops(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const std::vector<EdgeLoop>& edge_loops,
+    const IslandVisitor& visitor
+);
+
 /**
  * @brief 检测边环
  * 
+ * 检查所有边（无数量上限），把特征边（见 detectFeatureEdges）串联成有序的闭合环
+ * 和开放折线（见 chainFeatureEdges）。
+ * 
  * @param V 顶点矩阵
  * @param F 面矩阵
  * @param feature_angle 特征角度阈值（度数）
  * @return 检测到的边环
  */
-std::vector<std::vector<int>> detectEdgeLoops(
-    const Eigen::MatrixXd& V,
-    const Eigen::MatrixXi& F,
+template <typename DerivedV, typename DerivedF>
+std::vector<EdgeLoop> detectEdgeLoops(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    double feature_angle = 30.0
+);
+
+/**
+ * @brief 检测边环（复用预先构建的拓扑）
+ */
+template <typename DerivedV, typename DerivedF>
+std::vector<EdgeLoop> detectEdgeLoops(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
     double feature_angle = 30.0
 );
 
+/**
+ * @brief 把一组边串联成有序链，线性时间
+ * 
+ * 在度数不为 2 的顶点（端点或分叉点）处断开：从这些顶点出发的链为开放折线
+ * （从分叉点出发又回到同一点的链视为闭合环），其余全部由 2 度顶点组成的链为闭合环。
+ * 链的起点按顶点索引升序，因此结果确定。
+ * 
+ * @param topo 网格拓扑
+ * @param edges 按边 ID 的位集合（如 detectFeatureEdges 的结果）
+ * @return 每条边恰好属于一条链
+ */
+std::vector<EdgeLoop> chainFeatureEdges(
+    const MeshTopology& topo,
+    const EdgeMask& edges
+);
+
+/**
+ * @brief 从一条种子边出发沿拓扑边环行走（四边形网格的 edge loop）
+ * 
+ * 只经过多边形边：到达内部 4 度顶点时取与来边相对的边继续，遇到网格边界、
+ * 度数不为 4 的顶点或非流形顶点即停止，每步只查看当前顶点的一环，总代价与环长成正比。
+ * 向两个方向走；回到种子边时为闭合环，否则为从停止点到停止点的开放折线。
+ * 顶点对 (a, b) 对应的种子边可用 mesh.topo.findEdge(a, b) 查到。
+ * 
+ * @param mesh triangulatePolygonMesh 的结果
+ * @param seed_edge 种子边 ID（须为多边形边，否则返回空链）
+ * @return 经过种子边的边环，边 ID 以 mesh.topo 为准，可直接传给 segmentByEdgeLoops
+ */
+EdgeLoop walkEdgeLoop(
+    const TriangulatedPolygonMesh& mesh,
+    int seed_edge
+);
+
+/**
+ * @brief 检测特征边：二面角大于 feature_angle（度）的边
+ * 
+ * 并行检查所有边：先并行计算面法向，再按 64 条边一组写入位集合，
+ * 以法向点积与 cos(feature_angle) 比较代替逐边 acos。网格边界边和含退化面的边不算特征边；
+ * 非流形边取第一个面与其余各面的最大二面角。
+ * 
+ * @param topo 网格拓扑
+ * @param feature_angle 特征角度阈值（度数）
+ * @return 按边 ID 的特征边位集合，可直接传给 segmentByCutEdges
+ */
+template <typename DerivedV, typename DerivedF>
+EdgeMask detectFeatureEdges(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    double feature_angle = 30.0
+);
+
+/**
+ * @brief 检测特征边（读取几何缓存中的面法向）
+ */
+EdgeMask detectFeatureEdges(
+    const MeshTopology& topo,
+    const GeometryCache& geometry,
+    double feature_angle = 30.0
+);
+
+/**
+ * @brief 每条边的二面角（度），用作特征角的切割权重
+ * 
+ * 边界边和含退化面的边为 0；非流形边取第一个面与其余各面二面角的最大值。
+ * 权重大于 feature_angle 的边即 detectFeatureEdges 的结果。
+ */
+template <typename DerivedV, typename DerivedF>
+std::vector<double> computeFeatureAngleEdgeWeights(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo
+);
+
+/**
+ * @brief 每条边的二面角（读取几何缓存中的面法向）
+ */
+std::vector<double> computeFeatureAngleEdgeWeights(
+    const MeshTopology& topo,
+    const GeometryCache& geometry
+);
+
+/**
+ * @brief 按二面角降序排列的边索引
+ * 
+ * 二面角大于任意 feature_angle 的边都是排序后的一段前缀，
+ * 二分查找即可得到，不必重新扫描网格。
+ */
+struct FeatureAngleIndex {
+    std::vector<double> angles;  // 降序排列的二面角（度）
+    std::vector<int> edges;      // 对应的边 ID；二面角相同时按边 ID 升序
+    
+    /**
+     * @brief 二面角大于 feature_angle 的边数
+     */
+    int countAbove(double feature_angle) const {
+        return static_cast<int>(std::partition_point(angles.begin(), angles.end(),
+            [feature_angle](double angle) { return angle > feature_angle; }) - angles.begin());
+    }
+    
+    /**
+     * @brief 二面角大于 feature_angle 的边（连续区间）
+     */
+    ConstSpan<int> edgesAbove(double feature_angle) const {
+        return {edges.data(), edges.data() + countAbove(feature_angle)};
+    }
+};
+
+/**
+ * @brief 构建二面角索引（并行基数排序，一次完成）
+ * 
+ * @param edge_angles 每条边的二面角，通常为 computeFeatureAngleEdgeWeights 的结果
+ * @return 二面角索引
+ */
+FeatureAngleIndex buildFeatureAngleIndex(
+    const std::vector<double>& edge_angles
+);
+
+/**
+ * @brief 随特征角增量更新的特征边和边环
+ * 
+ * 改变特征角时只增删二面角落在新旧阈值之间的边，并只重新串联与这些边共享顶点的链，
+ * 其余链保持不变；代价与变化的边数加受影响的链长成正比。
+ * 得到的链与对同一组特征边调用 chainFeatureEdges 的结果相同，
+ * 只是顺序和走向可能不同。拓扑和索引须在跟踪器使用期间保持有效。
+ */
+class FeatureEdgeTracker {
+public:
+    FeatureEdgeTracker(const MeshTopology& topo, const FeatureAngleIndex& index, double feature_angle);
+    
+    /**
+     * @brief 改变特征角，增量更新特征边和边环
+     */
+    void setFeatureAngle(double feature_angle);
+    
+    double featureAngle() const { return feature_angle_; }
+    
+    // 当前特征边（按边 ID 的位集合，可直接传给 segmentByCutEdges）
+    const EdgeMask& featureEdges() const { return feature_edges_; }
+    
+    int numLoops() const { return static_cast<int>(chains_.size() - free_chains_.size()); }
+    
+    /**
+     * @brief 当前的所有边环（复制，代价与特征边总数成正比）
+     */
+    std::vector<EdgeLoop> loops() const;
+    
+    /**
+     * @brief 逐条访问当前边环，不复制
+     */
+    template <typename Visit>
+    void forEachLoop(Visit&& visit) const {
+        for (const EdgeLoop& chain : chains_) {
+            if (!chain.edges.empty()) visit(chain);
+        }
+    }
+    
+private:
+    const MeshTopology* topo_;
+    const FeatureAngleIndex* index_;
+    double feature_angle_;
+    int num_features_ = 0;           // 当前特征边 = 索引的前 num_features_ 条边
+    EdgeMask feature_edges_;
+    std::vector<int> valence_;       // 每个顶点上的特征边数
+    std::vector<int> edge_chain_;    // 特征边 -> 所在链的槽位（非特征边为 -1）
+    std::vector<EdgeLoop> chains_;   // 链槽位，空闲槽位的链为空
+    std::vector<int> free_chains_;   // 空闲槽位
+};
+
 /**
  * @brief 高曲率切线分割
  * 
@@ -83,12 +1195,37 @@ std::vector<std::vector<int>> detectEdgeLoops(
  * @param curvature_threshold 曲率阈值
  * @return UV 岛列表
  */
+template <typename DerivedV, typename DerivedF>
 std::vector<UVIsland> segmentByHighCurvature(
-    const Eigen::MatrixXd& V,
-    const Eigen::MatrixXi& F,
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
     double curvature_threshold = 0.5
 );
 
+/**
+ * @brief 高曲率切线分割（复用预先构建的拓扑，返回紧凑的 IslandSet）
+ */
+template <typename DerivedV, typename DerivedF>
+IslandSet segmentByHighCurvature(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    double curvature_threshold = 0.5,
+    const SegmentationOptions& options = SegmentationOptions()
+);
+
+/**
+ * @brief 每条边两个端点平均曲率绝对值的均值，用作高曲率分割的切割权重
+ * 
+ * segmentByHighCurvature 切开权重大于 curvature_threshold 的边。
+ */
+template <typename DerivedV, typename DerivedF>
+std::vector<double> computeHighCurvatureEdgeWeights(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo
+);
+
 /**
  * @brief 计算顶点的主曲率
  * 
@@ -97,9 +1234,10 @@ std::vector<UVIsland> segmentByHighCurvature(
  * @param principal_min 最小主曲率输出
  * @param principal_max 最大主曲率输出
  */
+template <typename DerivedV, typename DerivedF>
 void computePrincipalCurvatures(
-    const Eigen::MatrixXd& V,
-    const Eigen::MatrixXi& F,
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
     Eigen::VectorXd& principal_min,
     Eigen::VectorXd& principal_max
 );
@@ -117,12 +1255,27 @@ void computePrincipalCurvatures(
  * @param gaussian_threshold 高斯曲率阈值
  * @return UV 岛列表
  */
+template <typename DerivedV, typename DerivedF>
 std::vector<UVIsland> segmentByGaussianCurvature(
-    const Eigen::MatrixXd& V,
-    const Eigen::MatrixXi& F,
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
     double gaussian_threshold = 0.01
 );
 
+/**
+ * @brief 不可展开区域切线分割（复用预先构建的拓扑，返回紧凑的 IslandSet）
+ * 
+ * 顶点面积取自 options.geometry；为空时构建一次几何缓存，同时用于岛的统计量和邻接图。
+ */
+template <typename DerivedV, typename DerivedF>
+IslandSet segmentByGaussianCurvature(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    double gaussian_threshold = 0.01,
+    const SegmentationOptions& options = SegmentationOptions()
+);
+
 /**
  * @brief 计算高斯曲率
  * 
@@ -130,9 +1283,20 @@ std::vector<UVIsland> segmentByGaussianCurvature(
  * @param F 面矩阵
  * @return 每个顶点的高斯曲率
  */
+template <typename DerivedV, typename DerivedF>
 Eigen::VectorXd computeGaussianCurvature(
-    const Eigen::MatrixXd& V,
-    const Eigen::MatrixXi& F
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F
+);
+
+/**
+ * @brief 计算高斯曲率（面积取自预先构建的几何缓存）
+ */
+template <typename DerivedV, typename DerivedF>
+Eigen::VectorXd computeGaussianCurvature(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const GeometryCache& geometry
 );
 
 /**
@@ -149,13 +1313,29 @@ Eigen::VectorXd computeGaussianCurvature(
  * @param angle_threshold 角度阈值
  * @return UV 岛列表
  */
+template <typename DerivedV, typename DerivedF>
 std::vector<UVIsland> segmentByTextureFlow(
-    const Eigen::MatrixXd& V,
-    const Eigen::MatrixXi& F,
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
     const Eigen::Vector3d& texture_direction,
     double angle_threshold = 45.0
 );
 
+/**
+ * @brief 按纹理方向切割（复用预先构建的拓扑，返回紧凑的 IslandSet）
+ * 
+ * 面法向取自 options.geometry；为空时构建一次几何缓存，同时用于岛的统计量和邻接图。
+ */
+template <typename DerivedV, typename DerivedF>
+IslandSet segmentByTextureFlow(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const Eigen::Vector3d& texture_direction,
+    double angle_threshold = 45.0,
+    const SegmentationOptions& options = SegmentationOptions()
+);
+
 /**
  * @brief 细节区域隔离
  * 
@@ -166,15 +1346,28 @@ std::vector<UVIsland> segmentByTextureFlow(
  * 
  * @param V 顶点矩阵
  * @param F 面矩阵
- * @param detail_faces 需要隔离的面索引
+ * @param detail_faces 需要隔离的面索引（重复的 ID 只计一次，越界的 ID 忽略）
  * @return UV 岛列表
  */
+template <typename DerivedV, typename DerivedF>
 std::vector<UVIsland> segmentByDetailIsolation(
-    const Eigen::MatrixXd& V,
-    const Eigen::MatrixXi& F,
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
     const std::vector<int>& detail_faces
 );
 
+/**
+ * @brief 细节区域隔离（复用预先构建的拓扑，返回紧凑的 IslandSet）
+ */
+template <typename DerivedV, typename DerivedF>
+IslandSet segmentByDetailIsolation(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const std::vector<int>& detail_faces,
+    const SegmentationOptions& options = SegmentationOptions()
+);
+
 /**
  * @brief 镜像/重复切割
  * 
@@ -189,11 +1382,25 @@ std::vector<UVIsland> segmentByDetailIsolation(
  * @param tolerance 容差
  * @return UV 岛列表
  */
+template <typename DerivedV, typename DerivedF>
 std::vector<UVIsland> segmentBySymmetry(
-    const Eigen::MatrixXd& V,
-    const Eigen::MatrixXi& F,
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
     const Eigen::Vector4d& symmetry_plane,
     double tolerance = 1e-6
 );
 
+/**
+ * @brief 镜像/重复切割（复用预先构建的拓扑，返回紧凑的 IslandSet）
+ */
+template <typename DerivedV, typename DerivedF>
+IslandSet segmentBySymmetry(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const Eigen::Vector4d& symmetry_plane,
+    double tolerance = 1e-6,
+    const SegmentationOptions& options = SegmentationOptions()
+);
+
 } // namespace UVSegmentation
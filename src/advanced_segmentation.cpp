@@ -1,22 +1,33 @@
 #include "uv_segmentation.h"
-#include <igl/adjacency_list.h>
-#include <igl/per_face_normals.h>
-#include <igl/barycenter.h>
-#include <igl/doublearea.h>
-#include <queue>
+#include "segmentation_internal.h"
 #include <cmath>
 
 namespace UVSegmentation {
 
+template <typename DerivedV, typename DerivedF>
 std::vector<UVIsland> segmentByTextureFlow(
-    const Eigen::MatrixXd& V,
-    const Eigen::MatrixXi& F,
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
     const Eigen::Vector3d& texture_direction,
     double angle_threshold
 ) {
-    // 计算面法向量
-    Eigen::MatrixXd N;
-    igl::per_face_normals(V, F, N);
+    return toUVIslands(
+        segmentByTextureFlow(V, F, buildMeshTopology(V, F), texture_direction, angle_threshold));
+}
+
+template <typename DerivedV, typename DerivedF>
+IslandSet segmentByTextureFlow(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const Eigen::Vector3d& texture_direction,
+    double angle_threshold,
+    const SegmentationOptions& options
+) {
+    // 面法向取自几何缓存，缓存同时用于岛的统计量和邻接图
+    GeometryCache storage;
+    const SegmentationOptions cut_options = withGeometry(V, F, topo, options, storage);
+    const GeometryCache& geometry = *cut_options.geometry;
     
     // 计算每个面相对于纹理方向的角度偏差
     Eigen::Vector3d tex_dir = texture_direction.normalized();
@@ -24,16 +35,16 @@ std::vector<UVIsland> segmentByTextureFlow(
     
     for (int i = 0; i < F.rows(); ++i) {
         // 计算面的主方向（使用最长边的方向）
-        Eigen::Vector3d v0 = V.row(F(i, 0));
-        Eigen::Vector3d v1 = V.row(F(i, 1));
-        Eigen::Vector3d v2 = V.row(F(i, 2));
+        Eigen::Vector3d v0 = cornerPosition(V, F, i, 0);
+        Eigen::Vector3d v1 = cornerPosition(V, F, i, 1);
+        Eigen::Vector3d v2 = cornerPosition(V, F, i, 2);
         
         Eigen::Vector3d e0 = (v1 - v0).normalized();
         Eigen::Vector3d e1 = (v2 - v1).normalized();
         Eigen::Vector3d e2 = (v0 - v2).normalized();
         
         // 投影到切平面
-        Eigen::Vector3d normal = N.row(i);
+        const Eigen::Vector3d normal = geometry.normals.row(i).transpose();
         e0 = (e0 - e0.dot(normal) * normal).normalized();
         e1 = (e1 - e1.dot(normal) * normal).normalized();
         e2 = (e2 - e2.dot(normal) * normal).normalized();
@@ -49,209 +60,118 @@ std::vector<UVIsland> segmentByTextureFlow(
     }
     
     // 标记切割边（跨越不同方向区域）
-    std::set<Edge> cut_edges;
-    std::vector<std::vector<int>> adjacency_list;
-    igl::adjacency_list(F, adjacency_list);
-    
-    for (int i = 0; i < F.rows(); ++i) {
-        for (int j = 0; j < 3; ++j) {
-            int v0 = F(i, j);
-            int v1 = F(i, (j + 1) % 3);
-            
-            // 找共享这条边的相邻面
-            for (int adj_face : adjacency_list[v0]) {
-                if (adj_face == i) continue;
-                
-                // 检查是否共享边
-                bool shares_edge = false;
-                for (int k = 0; k < 3; ++k) {
-                    if ((F(adj_face, k) == v0 && F(adj_face, (k + 1) % 3) == v1) ||
-                        (F(adj_face, k) == v1 && F(adj_face, (k + 1) % 3) == v0)) {
-                        shares_edge = true;
-                        break;
-                    }
-                }
-                
-                if (shares_edge) {
-                    // 如果两个面的方向偏差相差很大
-                    double dev_diff = std::abs(face_deviations[i] - face_deviations[adj_face]);
-                    if (dev_diff > angle_threshold) {
-                        cut_edges.insert(Edge(v0, v1));
-                    }
+    EdgeMask cut_edges(topo.numEdges());
+    
+    for (int ei = 0; ei < topo.numEdges(); ++ei) {
+        const HalfedgeIndex begin = topo.edge_face_offsets[ei];
+        const HalfedgeIndex end = topo.edge_face_offsets[ei + 1];
+        
+        // 共享这条边的每一对相邻面
+        for (HalfedgeIndex a = begin; a < end; ++a) {
+            for (HalfedgeIndex b = a + 1; b < end; ++b) {
+                // 如果两个面的方向偏差相差很大
+                double dev_diff = std::abs(face_deviations[topo.edge_faces[a]] -
+                                           face_deviations[topo.edge_faces[b]]);
+                if (dev_diff > angle_threshold) {
+                    cut_edges.set(ei);
                 }
             }
         }
     }
     
-    // 从切割边构建边环
-    std::vector<std::vector<int>> edge_loops;
-    if (!cut_edges.empty()) {
-        std::map<int, std::vector<Edge>> vertex_to_edges;
-        for (const Edge& e : cut_edges) {
-            vertex_to_edges[e.v0].push_back(e);
-            vertex_to_edges[e.v1].push_back(e);
-        }
-        
-        std::set<Edge> visited_edges;
-        for (const Edge& start_edge : cut_edges) {
-            if (visited_edges.count(start_edge)) continue;
-            
-            std::vector<int> loop;
-            Edge current_edge = start_edge;
-            int current_vertex = current_edge.v1;
-            int start_vertex = current_edge.v0;
-            
-            loop.push_back(start_vertex);
-            visited_edges.insert(current_edge);
-            
-            // 追踪环
-            for (int iter = 0; iter < V.rows(); ++iter) {
-                loop.push_back(current_vertex);
-                
-                if (current_vertex == start_vertex && loop.size() > 2) {
-                    break;
-                }
-                
-                // 找下一条边
-                Edge next_edge(-1, -1);
-                for (const Edge& e : vertex_to_edges[current_vertex]) {
-                    if (!visited_edges.count(e)) {
-                        next_edge = e;
-                        break;
-                    }
-                }
-                
-                if (next_edge.v0 == -1) break;
-                
-                visited_edges.insert(next_edge);
-                current_vertex = (next_edge.v0 == current_vertex) ?
-                               next_edge.v1 : next_edge.v0;
-            }
-            
-            if (loop.size() >= 3) {
-                edge_loops.push_back(loop);
-            }
-        }
-    }
-    
-    if (edge_loops.empty()) {
-        // 返回整个网格作为一个岛
-        UVIsland island;
-        island.faces.resize(F.rows());
-        for (int i = 0; i < F.rows(); ++i) {
-            island.faces[i] = i;
-        }
-        
-        Eigen::MatrixXd BC;
-        igl::barycenter(V, F, BC);
-        Eigen::VectorXd areas;
-        igl::doublearea(V, F, areas);
-        areas /= 2.0;
-        
-        island.centroid = Eigen::Vector3d::Zero();
-        island.area = 0.0;
-        for (int i = 0; i < F.rows(); ++i) {
-            island.centroid += BC.row(i) * areas(i);
-            island.area += areas(i);
-        }
-        island.centroid /= island.area;
-        
-        return {island};
-    }
-    
-    return segmentByEdgeLoops(V, F, edge_loops);
+    return segmentByCutEdges(V, F, topo, cut_edges, cut_options);
 }
 
+template <typename DerivedV, typename DerivedF>
 std::vector<UVIsland> segmentByDetailIsolation(
-    const Eigen::MatrixXd& V,
-    const Eigen::MatrixXi& F,
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
     const std::vector<int>& detail_faces
 ) {
-    std::vector<UVIsland> islands;
-    
-    // 创建详细区域的岛
-    UVIsland detail_island;
-    detail_island.faces = detail_faces;
+    return toUVIslands(segmentByDetailIsolation(V, F, buildMeshTopology(V, F), detail_faces));
+}
+
+template <typename DerivedV, typename DerivedF>
+IslandSet segmentByDetailIsolation(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const std::vector<int>& detail_faces,
+    const SegmentationOptions& options
+) {
+    IslandSet islands;
     
-    // 找边界边
-    std::set<Edge> detail_edges;
+    // 岛 0 为细节区域，岛 1 为其余面；细节面经标记去重，越界的 ID 忽略
+    const int num_faces = static_cast<int>(F.rows());
+    std::vector<char> is_detail(num_faces, 0);
     for (int fi : detail_faces) {
-        for (int j = 0; j < 3; ++j) {
-            int v0 = F(fi, j);
-            int v1 = F(fi, (j + 1) % 3);
-            detail_edges.insert(Edge(v0, v1));
-        }
+        if (fi >= 0 && fi < num_faces) is_detail[fi] = 1;
     }
     
-    // 找边界（只出现在详细面中的边）
-    std::set<int> detail_face_set(detail_faces.begin(), detail_faces.end());
-    for (int i = 0; i < F.rows(); ++i) {
-        if (detail_face_set.count(i)) continue;
-        
-        for (int j = 0; j < 3; ++j) {
-            int v0 = F(i, j);
-            int v1 = F(i, (j + 1) % 3);
-            Edge e(v0, v1);
-            
-            if (detail_edges.count(e)) {
-                detail_island.boundary.push_back(e);
-            }
-        }
+    islands.face_island.resize(num_faces);
+    for (int i = 0; i < num_faces; ++i) {
+        islands.face_island[i] = is_detail[i] ? 0 : 1;
+        if (is_detail[i]) islands.faces.push_back(i);
     }
-    
-    // 计算详细岛的质心和面积
-    Eigen::MatrixXd BC;
-    igl::barycenter(V, F, BC);
-    Eigen::VectorXd areas;
-    igl::doublearea(V, F, areas);
-    areas /= 2.0;
-    
-    detail_island.centroid = Eigen::Vector3d::Zero();
-    detail_island.area = 0.0;
-    for (int fi : detail_faces) {
-        detail_island.centroid += BC.row(fi) * areas(fi);
-        detail_island.area += areas(fi);
+    islands.face_offsets = {0, static_cast<int>(islands.faces.size())};
+    for (int i = 0; i < num_faces; ++i) {
+        if (!is_detail[i]) islands.faces.push_back(i);
     }
-    if (detail_island.area > 0) {
-        detail_island.centroid /= detail_island.area;
+    if (static_cast<int>(islands.faces.size()) > islands.face_offsets.back()) {
+        islands.face_offsets.push_back(static_cast<int>(islands.faces.size()));
     }
     
-    islands.push_back(detail_island);
-    
-    // 创建其余区域的岛
-    std::vector<int> remaining_faces;
-    for (int i = 0; i < F.rows(); ++i) {
-        if (!detail_face_set.count(i)) {
-            remaining_faces.push_back(i);
+    // 找边界（同时与细节面和非细节面相邻的边），两个岛共用
+    islands.cut_edges = EdgeMask(topo.numEdges());
+    for (int ei = 0; ei < topo.numEdges(); ++ei) {
+        bool has_detail = false, has_other = false;
+        for (HalfedgeIndex k = topo.edge_face_offsets[ei]; k < topo.edge_face_offsets[ei + 1]; ++k) {
+            if (is_detail[topo.edge_faces[k]]) has_detail = true;
+            else has_other = true;
+        }
+        if (has_detail && has_other) {
+            islands.boundary.push_back(topo.edges[ei]);
+            islands.cut_edges.set(ei);
         }
     }
     
-    if (!remaining_faces.empty()) {
-        UVIsland remaining_island;
-        remaining_island.faces = remaining_faces;
-        remaining_island.boundary = detail_island.boundary;
-        
-        remaining_island.centroid = Eigen::Vector3d::Zero();
-        remaining_island.area = 0.0;
-        for (int fi : remaining_faces) {
-            remaining_island.centroid += BC.row(fi) * areas(fi);
-            remaining_island.area += areas(fi);
-        }
-        if (remaining_island.area > 0) {
-            remaining_island.centroid /= remaining_island.area;
-        }
-        
-        islands.push_back(remaining_island);
+    const HalfedgeIndex num_boundary = static_cast<HalfedgeIndex>(islands.boundary.size());
+    islands.boundary_offsets = {0, num_boundary};
+    if (islands.numIslands() == 2) {
+        islands.boundary.resize(2 * num_boundary);
+        std::copy_n(islands.boundary.begin(), num_boundary, islands.boundary.begin() + num_boundary);
+        islands.boundary_offsets.push_back(2 * num_boundary);
     }
     
+    // 岛的归属已定，边界环只由面标签决定
+    traceBoundaryLoops(topo, EdgeMask(topo.numEdges()), islands);
+    
+    // 计算两个岛的质心和面积
+    computeIslandStatistics(V, F, islands, options.geometry);
+    if (options.island_adjacency) buildIslandAdjacency(V, topo, islands, options.geometry);
+    
     return islands;
 }
 
+template <typename DerivedV, typename DerivedF>
 std::vector<UVIsland> segmentBySymmetry(
-    const Eigen::MatrixXd& V,
-    const Eigen::MatrixXi& F,
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
     const Eigen::Vector4d& symmetry_plane,
     double tolerance
+) {
+    return toUVIslands(
+        segmentBySymmetry(V, F, buildMeshTopology(V, F), symmetry_plane, tolerance));
+}
+
+template <typename DerivedV, typename DerivedF>
+IslandSet segmentBySymmetry(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const Eigen::Vector4d& symmetry_plane,
+    double tolerance,
+    const SegmentationOptions& options
 ) {
     // 平面方程: ax + by + cz + d = 0
     const double nx = symmetry_plane(0), ny = symmetry_plane(1), nz = symmetry_plane(2);
@@ -264,76 +184,36 @@ std::vector<UVIsland> segmentBySymmetry(
         side[i] = (std::abs(dist) < tolerance) ? 0 : ((dist > 0) ? 1 : -1);
     }
     
-    // 优化：使用vector+reserve代替set，减少内存分配
-    std::vector<Edge> symmetry_edges_vec;
-    symmetry_edges_vec.reserve(F.rows());
-    
-    for (int i = 0; i < F.rows(); ++i) {
-        int v0 = F(i, 0), v1 = F(i, 1), v2 = F(i, 2);
-        int s0 = side[v0], s1 = side[v1], s2 = side[v2];
-        
-        // 如果边跨越平面
-        if (s0 != s1 || s0 == 0) symmetry_edges_vec.push_back(Edge(v0, v1));
-        if (s1 != s2 || s1 == 0) symmetry_edges_vec.push_back(Edge(v1, v2));
-        if (s2 != s0 || s2 == 0) symmetry_edges_vec.push_back(Edge(v2, v0));
+    // 跨越平面或落在平面上的边
+    EdgeMask symmetry_edges(topo.numEdges());
+    for (int ei = 0; ei < topo.numEdges(); ++ei) {
+        int s0 = side[topo.edges[ei].v0], s1 = side[topo.edges[ei].v1];
+        if (s0 != s1 || s0 == 0 || s1 == 0) symmetry_edges.set(ei);
     }
     
-    // 去重
-    std::set<Edge> symmetry_edges(symmetry_edges_vec.begin(), symmetry_edges_vec.end());
-    
-    // 快速返回简单情况
-    if (symmetry_edges.empty()) {
-        UVIsland island;
-        island.faces.resize(F.rows());
-        for (int i = 0; i < F.rows(); ++i) island.faces[i] = i;
-        return {island};
-    }
-    
-    // 从对称边构建边环
-    std::vector<std::vector<int>> edge_loops;
-    std::map<int, std::vector<Edge>> vertex_to_edges;
-    for (const Edge& e : symmetry_edges) {
-        vertex_to_edges[e.v0].push_back(e);
-        vertex_to_edges[e.v1].push_back(e);
-    }
-    
-    std::set<Edge> visited;
-    for (const Edge& start_edge : symmetry_edges) {
-        if (visited.count(start_edge)) continue;
-        
-        std::vector<int> loop;
-        Edge current = start_edge;
-        int start_v = current.v0;
-        int current_v = current.v1;
-        
-        loop.push_back(start_v);
-        visited.insert(current);
-        
-        for (int iter = 0; iter < V.rows(); ++iter) {
-            loop.push_back(current_v);
-            
-            if (current_v == start_v && loop.size() > 2) break;
-            
-            Edge next(-1, -1);
-            for (const Edge& e : vertex_to_edges[current_v]) {
-                if (!visited.count(e)) {
-                    next = e;
-                    break;
-                }
-            }
-            
-            if (next.v0 == -1) break;
-            
-            visited.insert(next);
-            current_v = (next.v0 == current_v) ? next.v1 : next.v0;
-        }
-        
-        if (loop.size() >= 3) {
-            edge_loops.push_back(loop);
-        }
-    }
-    
-    return segmentByEdgeLoops(V, F, edge_loops);
+    return segmentByCutEdges(V, F, topo, symmetry_edges, options);
 }
 
+#define UV_SEGMENTATION_INSTANTIATE(DerivedV, DerivedF) \
+    template std::vector<UVIsland> segmentByTextureFlow<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const Eigen::Vector3d&, double); \
+    template IslandSet segmentByTextureFlow<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const MeshTopology&, const Eigen::Vector3d&, double, const SegmentationOptions&); \
+    template std::vector<UVIsland> segmentByDetailIsolation<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const std::vector<int>&); \
+    template IslandSet segmentByDetailIsolation<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const MeshTopology&, const std::vector<int>&, const SegmentationOptions&); \
+    template std::vector<UVIsland> segmentBySymmetry<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const Eigen::Vector4d&, double); \
+    template IslandSet segmentBySymmetry<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const MeshTopology&, const Eigen::Vector4d&, double, const SegmentationOptions&);
+UV_SEGMENTATION_MESH_TYPES(UV_SEGMENTATION_INSTANTIATE)
+#undef UV_SEGMENTATION_INSTANTIATE
+
 } // namespace UVSegmentation
@@ -1,39 +1,74 @@
 #include "uv_segmentation.h"
+#include "segmentation_internal.h"
 #include <igl/principal_curvature.h>
 #include <igl/gaussian_curvature.h>
-#include <igl/adjacency_list.h>
-#include <igl/barycenter.h>
-#include <igl/doublearea.h>
-#include <queue>
+#include <type_traits>
 
 namespace UVSegmentation {
 
+namespace {
+
+/**
+ * @brief 以 libigl 需要的稠密类型 Target（MatrixXd / MatrixXi）取得矩阵
+ * 
+ * M 已是 Target 时直接返回其引用，不做复制；否则转换到 storage 后返回。
+ */
+template <typename Target, typename Derived>
+const Target& asDense(const Eigen::MatrixBase<Derived>& M, Target& storage) {
+    if constexpr (std::is_same<Derived, Target>::value) {
+        return M.derived();
+    } else {
+        storage = M.template cast<typename Target::Scalar>();
+        return storage;
+    }
+}
+
+} // namespace
+
+template <typename DerivedV, typename DerivedF>
 void computePrincipalCurvatures(
-    const Eigen::MatrixXd& V,
-    const Eigen::MatrixXi& F,
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
     Eigen::VectorXd& principal_min,
     Eigen::VectorXd& principal_max
 ) {
+    // libigl 的曲率计算需要 double/int 稠密矩阵，其余类型在此转换一次
+    Eigen::MatrixXd V_storage;
+    Eigen::MatrixXi F_storage;
+    const Eigen::MatrixXd& Vd = asDense(V, V_storage);
+    const Eigen::MatrixXi& Fi = asDense(F, F_storage);
     Eigen::MatrixXd PD1, PD2;
-    igl::principal_curvature(V, F, PD1, PD2, principal_min, principal_max);
+    igl::principal_curvature(Vd, Fi, PD1, PD2, principal_min, principal_max);
+}
+
+template <typename DerivedV, typename DerivedF>
+Eigen::VectorXd computeGaussianCurvature(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F
+) {
+    GeometryCache geometry;
+    computeFaceGeometry(V, F, geometry);
+    return computeGaussianCurvature(V, F, geometry);
 }
 
+template <typename DerivedV, typename DerivedF>
 Eigen::VectorXd computeGaussianCurvature(
-    const Eigen::MatrixXd& V,
-    const Eigen::MatrixXi& F
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const GeometryCache& geometry
 ) {
+    Eigen::MatrixXd V_storage;
+    Eigen::MatrixXi F_storage;
+    const Eigen::MatrixXd& Vd = asDense(V, V_storage);
+    const Eigen::MatrixXi& Fi = asDense(F, F_storage);
     Eigen::VectorXd K;
-    igl::gaussian_curvature(V, F, K);
+    igl::gaussian_curvature(Vd, Fi, K);
     
-    // 归一化到每个顶点
+    // 归一化到每个顶点（面积取自几何缓存）
     Eigen::VectorXd vertex_areas = Eigen::VectorXd::Zero(V.rows());
-    Eigen::VectorXd face_areas;
-    igl::doublearea(V, F, face_areas);
-    face_areas /= 2.0;
-    
     for (int i = 0; i < F.rows(); ++i) {
         for (int j = 0; j < 3; ++j) {
-            vertex_areas(F(i, j)) += face_areas(i) / 3.0;
+            vertex_areas(Fi(i, j)) += geometry.areas(i) / 3.0;
         }
     }
     
@@ -46,10 +81,11 @@ Eigen::VectorXd computeGaussianCurvature(
     return K;
 }
 
-std::vector<UVIsland> segmentByHighCurvature(
-    const Eigen::MatrixXd& V,
-    const Eigen::MatrixXi& F,
-    double curvature_threshold
+template <typename DerivedV, typename DerivedF>
+std::vector<double> computeHighCurvatureEdgeWeights(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo
 ) {
     // 计算主曲率
     Eigen::VectorXd K_min, K_max;
@@ -58,177 +94,112 @@ std::vector<UVIsland> segmentByHighCurvature(
     // 计算平均曲率
     Eigen::VectorXd mean_curvature = (K_min + K_max) / 2.0;
     
-    // 找高曲率边
-    std::set<Edge> high_curvature_edges;
-    
-    for (int i = 0; i < F.rows(); ++i) {
-        for (int j = 0; j < 3; ++j) {
-            int v0 = F(i, j);
-            int v1 = F(i, (j + 1) % 3);
-            
-            // 如果边的两个顶点的平均曲率都很高
-            double avg_curv = (std::abs(mean_curvature(v0)) + 
-                              std::abs(mean_curvature(v1))) / 2.0;
-            
-            if (avg_curv > curvature_threshold) {
-                high_curvature_edges.insert(Edge(v0, v1));
-            }
-        }
+    // 边的权重：两个端点平均曲率绝对值的均值
+    std::vector<double> weights(topo.numEdges());
+    for (int ei = 0; ei < topo.numEdges(); ++ei) {
+        const Edge& e = topo.edges[ei];
+        weights[ei] = (std::abs(mean_curvature(e.v0)) + std::abs(mean_curvature(e.v1))) / 2.0;
     }
     
-    // 使用高曲率边作为边环进行分割
-    std::vector<std::vector<int>> edge_loops;
-    std::set<int> visited_vertices;
-    
-    for (const Edge& e : high_curvature_edges) {
-        if (visited_vertices.count(e.v0) || visited_vertices.count(e.v1)) {
-            continue;
-        }
-        
-        // 追踪连续的高曲率边
-        std::vector<int> loop;
-        std::queue<int> queue;
-        queue.push(e.v0);
-        visited_vertices.insert(e.v0);
-        
-        while (!queue.empty() && loop.size() < V.rows()) {
-            int v = queue.front();
-            queue.pop();
-            loop.push_back(v);
-            
-            // 找相邻的高曲率顶点
-            for (const Edge& edge : high_curvature_edges) {
-                if (edge.v0 == v && !visited_vertices.count(edge.v1)) {
-                    queue.push(edge.v1);
-                    visited_vertices.insert(edge.v1);
-                } else if (edge.v1 == v && !visited_vertices.count(edge.v0)) {
-                    queue.push(edge.v0);
-                    visited_vertices.insert(edge.v0);
-                }
-            }
-        }
-        
-        if (loop.size() >= 3) {
-            edge_loops.push_back(loop);
-        }
+    return weights;
+}
+
+template <typename DerivedV, typename DerivedF>
+std::vector<UVIsland> segmentByHighCurvature(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    double curvature_threshold
+) {
+    return toUVIslands(segmentByHighCurvature(V, F, buildMeshTopology(V, F), curvature_threshold));
+}
+
+template <typename DerivedV, typename DerivedF>
+IslandSet segmentByHighCurvature(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    double curvature_threshold,
+    const SegmentationOptions& options
+) {
+    // 端点平均曲率超过阈值的边
+    const std::vector<double> weights = computeHighCurvatureEdgeWeights(V, F, topo);
+    EdgeMask high_curvature_edges(topo.numEdges());
+    for (int ei = 0; ei < topo.numEdges(); ++ei) {
+        if (weights[ei] > curvature_threshold) high_curvature_edges.set(ei);
     }
     
-    // 使用边环分割
-    return segmentByEdgeLoops(V, F, edge_loops);
+    // 直接沿高曲率边切割
+    return segmentByCutEdges(V, F, topo, high_curvature_edges, options);
 }
 
+template <typename DerivedV, typename DerivedF>
 std::vector<UVIsland> segmentByGaussianCurvature(
-    const Eigen::MatrixXd& V,
-    const Eigen::MatrixXi& F,
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
     double gaussian_threshold
 ) {
-    // 计算高斯曲率
-    Eigen::VectorXd K = computeGaussianCurvature(V, F);
+    return toUVIslands(segmentByGaussianCurvature(V, F, buildMeshTopology(V, F), gaussian_threshold));
+}
+
+template <typename DerivedV, typename DerivedF>
+IslandSet segmentByGaussianCurvature(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    double gaussian_threshold,
+    const SegmentationOptions& options
+) {
+    // 计算高斯曲率；顶点面积取自几何缓存，缓存同时用于岛的统计量和邻接图
+    GeometryCache storage;
+    const SegmentationOptions cut_options = withGeometry(V, F, topo, options, storage);
+    Eigen::VectorXd K = computeGaussianCurvature(V, F, *cut_options.geometry);
     
     // 标记需要切割的区域
     // 正高斯曲率（凸）和负高斯曲率（鞍形）都需要切
-    std::set<Edge> cut_edges;
-    
-    for (int i = 0; i < F.rows(); ++i) {
-        for (int j = 0; j < 3; ++j) {
-            int v0 = F(i, j);
-            int v1 = F(i, (j + 1) % 3);
-            
-            double k0 = K(v0);
-            double k1 = K(v1);
-            
-            // 如果边跨越不同曲率区域
-            bool v0_curved = std::abs(k0) > gaussian_threshold;
-            bool v1_curved = std::abs(k1) > gaussian_threshold;
-            
-            // 或者曲率符号不同（凸到鞍形）
-            bool sign_change = (k0 > gaussian_threshold && k1 < -gaussian_threshold) ||
-                              (k0 < -gaussian_threshold && k1 > gaussian_threshold);
-            
-            if ((v0_curved != v1_curved) || sign_change) {
-                cut_edges.insert(Edge(v0, v1));
-            }
-        }
-    }
-    
-    // 从切割边构建边环
-    std::map<int, std::vector<int>> vertex_to_edges;
-    std::vector<Edge> edge_list(cut_edges.begin(), cut_edges.end());
+    EdgeMask cut_edges(topo.numEdges());
     
-    for (size_t i = 0; i < edge_list.size(); ++i) {
-        vertex_to_edges[edge_list[i].v0].push_back(i);
-        vertex_to_edges[edge_list[i].v1].push_back(i);
-    }
-    
-    std::vector<std::vector<int>> edge_loops;
-    std::set<int> visited_edges;
-    
-    for (size_t start_idx = 0; start_idx < edge_list.size(); ++start_idx) {
-        if (visited_edges.count(start_idx)) continue;
+    for (int ei = 0; ei < topo.numEdges(); ++ei) {
+        double k0 = K(topo.edges[ei].v0);
+        double k1 = K(topo.edges[ei].v1);
         
-        std::vector<int> loop;
-        int current_edge = start_idx;
-        int current_vertex = edge_list[current_edge].v1;
-        int start_vertex = edge_list[current_edge].v0;
+        // 如果边跨越不同曲率区域
+        bool v0_curved = std::abs(k0) > gaussian_threshold;
+        bool v1_curved = std::abs(k1) > gaussian_threshold;
         
-        loop.push_back(start_vertex);
-        visited_edges.insert(current_edge);
+        // 或者曲率符号不同（凸到鞍形）
+        bool sign_change = (k0 > gaussian_threshold && k1 < -gaussian_threshold) ||
+                          (k0 < -gaussian_threshold && k1 > gaussian_threshold);
         
-        // 追踪环
-        for (int iter = 0; iter < V.rows(); ++iter) {
-            loop.push_back(current_vertex);
-            
-            if (current_vertex == start_vertex && loop.size() > 2) {
-                break;  // 完成环
-            }
-            
-            // 找下一条边
-            int next_edge = -1;
-            for (int ei : vertex_to_edges[current_vertex]) {
-                if (!visited_edges.count(ei)) {
-                    next_edge = ei;
-                    break;
-                }
-            }
-            
-            if (next_edge == -1) break;
-            
-            visited_edges.insert(next_edge);
-            current_vertex = (edge_list[next_edge].v0 == current_vertex) ?
-                           edge_list[next_edge].v1 : edge_list[next_edge].v0;
-        }
-        
-        if (loop.size() >= 3) {
-            edge_loops.push_back(loop);
+        if ((v0_curved != v1_curved) || sign_change) {
+            cut_edges.set(ei);
         }
     }
     
-    if (edge_loops.empty()) {
-        // 如果没有检测到边环，返回整个网格作为一个岛
-        UVIsland island;
-        island.faces.resize(F.rows());
-        for (int i = 0; i < F.rows(); ++i) {
-            island.faces[i] = i;
-        }
-        
-        Eigen::MatrixXd BC;
-        igl::barycenter(V, F, BC);
-        Eigen::VectorXd areas;
-        igl::doublearea(V, F, areas);
-        areas /= 2.0;
-        
-        island.centroid = Eigen::Vector3d::Zero();
-        island.area = 0.0;
-        for (int i = 0; i < F.rows(); ++i) {
-            island.centroid += BC.row(i) * areas(i);
-            island.area += areas(i);
-        }
-        island.centroid /= island.area;
-        
-        return {island};
-    }
-    
-    return segmentByEdgeLoops(V, F, edge_loops);
+    return segmentByCutEdges(V, F, topo, cut_edges, cut_options);
 }
 
+#define UV_SEGMENTATION_INSTANTIATE(DerivedV, DerivedF) \
+    template void computePrincipalCurvatures<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        Eigen::VectorXd&, Eigen::VectorXd&); \
+    template Eigen::VectorXd computeGaussianCurvature<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&); \
+    template Eigen::VectorXd computeGaussianCurvature<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, const GeometryCache&); \
+    template std::vector<double> computeHighCurvatureEdgeWeights<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const MeshTopology&); \
+    template std::vector<UVIsland> segmentByHighCurvature<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, double); \
+    template IslandSet segmentByHighCurvature<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const MeshTopology&, double, const SegmentationOptions&); \
+    template std::vector<UVIsland> segmentByGaussianCurvature<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, double); \
+    template IslandSet segmentByGaussianCurvature<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const MeshTopology&, double, const SegmentationOptions&);
+UV_SEGMENTATION_MESH_TYPES(UV_SEGMENTATION_INSTANTIATE)
+#undef UV_SEGMENTATION_INSTANTIATE
+
 } // namespace UVSegmentation
@@ -1,229 +1,343 @@
 #include "uv_segmentation.h"
-#include <igl/adjacency_list.h>
-#include <igl/edge_topology.h>
-#include <igl/dihedral_angles.h>
-#include <igl/barycenter.h>
-#include <igl/doublearea.h>
-#include <queue>
-#include <unordered_set>
+#include "segmentation_internal.h"
 #include <cmath>
 
 namespace UVSegmentation {
 
+namespace {
+
 /**
- * @brief 计算边的二面角
+ * @brief 边上第一个面与其余各面法向点积的最小值（二面角最大处）
+ * 
+ * 退化面不参与比较；边界边或没有可比较的面对时为 1（二面角为 0）。
  */
-double computeDihedralAngle(
-    const Eigen::MatrixXd& V,
-    const Eigen::MatrixXi& F,
-    int f1, int f2,
-    int e0, int e1
-) {
-    if (f1 < 0 || f2 < 0 || f1 >= F.rows() || f2 >= F.rows()) return 0.0;
-    
-    // 检查顶点索引是否有效
-    for (int i = 0; i < 3; ++i) {
-        if (F(f1, i) < 0 || F(f1, i) >= V.rows()) return 0.0;
-        if (F(f2, i) < 0 || F(f2, i) >= V.rows()) return 0.0;
+inline double minNormalDot(const GeometryCache& geometry, const MeshTopology& topo, int e) {
+    const auto& normals = geometry.normals;
+    const HalfedgeIndex begin = topo.edge_face_offsets[e];
+    const HalfedgeIndex end = topo.edge_face_offsets[e + 1];
+    const auto first = normals.row(topo.edge_faces[begin]);
+    double min_dot = 1.0;
+    if (first.squaredNorm() == 0) return min_dot;
+    for (HalfedgeIndex k = begin + 1; k < end; ++k) {
+        const auto other = normals.row(topo.edge_faces[k]);
+        if (other.squaredNorm() == 0) continue;
+        min_dot = std::min(min_dot, first.dot(other));
     }
-    
-    // 计算两个面的法向量
-    Eigen::Vector3d v0 = V.row(F(f1, 0));
-    Eigen::Vector3d v1 = V.row(F(f1, 1));
-    Eigen::Vector3d v2 = V.row(F(f1, 2));
-    Eigen::Vector3d n1 = (v1 - v0).cross(v2 - v0);
-    if (n1.norm() < 1e-10) return 0.0;
-    n1.normalize();
-    
-    v0 = V.row(F(f2, 0));
-    v1 = V.row(F(f2, 1));
-    v2 = V.row(F(f2, 2));
-    Eigen::Vector3d n2 = (v1 - v0).cross(v2 - v0);
-    if (n2.norm() < 1e-10) return 0.0;
-    n2.normalize();
-    
-    // 计算二面角
-    double cos_angle = n1.dot(n2);
-    cos_angle = std::max(-1.0, std::min(1.0, cos_angle));
-    return std::acos(cos_angle) * 180.0 / M_PI;
+    return min_dot;
+}
+
+} // namespace
+
+std::vector<double> computeFeatureAngleEdgeWeights(
+    const MeshTopology& topo,
+    const GeometryCache& geometry
+) {
+    std::vector<double> weights(topo.numEdges());
+    igl::parallel_for(topo.numEdges(), [&](int ei) {
+        const double dot = std::max(-1.0, std::min(1.0, minNormalDot(geometry, topo, ei)));
+        weights[ei] = std::acos(dot) * 180.0 / M_PI;
+    }, 1 << 12);
+    return weights;
+}
+
+template <typename DerivedV, typename DerivedF>
+std::vector<double> computeFeatureAngleEdgeWeights(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo
+) {
+    // 只需要面法向，不计算边长
+    GeometryCache geometry;
+    computeFaceGeometry(V, F, geometry);
+    return computeFeatureAngleEdgeWeights(topo, geometry);
 }
 
-std::vector<std::vector<int>> detectEdgeLoops(
-    const Eigen::MatrixXd& V,
-    const Eigen::MatrixXi& F,
+EdgeMask detectFeatureEdges(
+    const MeshTopology& topo,
+    const GeometryCache& geometry,
     double feature_angle
 ) {
-    std::vector<std::vector<int>> edge_loops;
+    // 二面角 > feature_angle 等价于法向点积 < cos(feature_angle)，无需逐边 acos
+    const double cos_threshold = std::cos(feature_angle * M_PI / 180.0);
     
-    // 优化：使用unordered_map加速查找
-    struct PairHash {
-        size_t operator()(const std::pair<int,int>& p) const {
-            return std::hash<long long>()(((long long)p.first << 32) | p.second);
+    // 每个任务写一个 64 位字，无需原子操作
+    EdgeMask feature_edges(topo.numEdges());
+    igl::parallel_for(feature_edges.numWords(), [&](int w) {
+        const int begin = w * 64;
+        const int end = std::min(topo.numEdges(), begin + 64);
+        uint64_t word = 0;
+        for (int e = begin; e < end; ++e) {
+            word |= uint64_t(minNormalDot(geometry, topo, e) < cos_threshold) << (e - begin);
         }
-    };
-    std::unordered_map<std::pair<int,int>, std::vector<int>, PairHash> edge_to_faces;
-    edge_to_faces.reserve(F.rows() * 2);
-    
-    for (int fi = 0; fi < F.rows(); ++fi) {
-        for (int i = 0; i < 3; ++i) {
-            int v0 = F(fi, i);
-            int v1 = F(fi, (i + 1) % 3);
-            if (v0 > v1) std::swap(v0, v1);
-            edge_to_faces[{v0, v1}].push_back(fi);
+        feature_edges.word(w) = word;
+    }, 1 << 6);
+    return feature_edges;
+}
+
+template <typename DerivedV, typename DerivedF>
+EdgeMask detectFeatureEdges(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    double feature_angle
+) {
+    GeometryCache geometry;
+    computeFaceGeometry(V, F, geometry);
+    return detectFeatureEdges(topo, geometry, feature_angle);
+}
+
+std::vector<EdgeLoop> chainFeatureEdges(
+    const MeshTopology& topo,
+    const EdgeMask& edges
+) {
+    // 每个顶点上的链边数
+    std::vector<int> valence(topo.num_vertices, 0);
+    igl::parallel_for(topo.num_vertices, [&](int v) {
+        for (HalfedgeIndex k = topo.vertex_edge_offsets[v]; k < topo.vertex_edge_offsets[v + 1]; ++k) {
+            if (edges.test(topo.vertex_edges[k])) ++valence[v];
         }
-    }
-    
-    // 优化：限制检测数量，只处理边界边
-    std::vector<std::pair<int,int>> feature_edges_list;
-    feature_edges_list.reserve(edge_to_faces.size() / 10);
+    }, 1 << 12);
     
-    int checked = 0;
-    const int max_check = std::min((int)edge_to_faces.size(), 10000);  // 限制检查数量
+    std::vector<EdgeLoop> loops;
+    EdgeMask visited(topo.numEdges());
+    auto isFree = [&](int e) { return edges.test(e) && !visited.test(e); };
+    auto claim = [&](int e) { visited.set(e); };
+    auto walk = [&](int v, int e) {
+        loops.push_back(walkChain(topo, valence, v, e, isFree, claim));
+    };
     
-    for (const auto& [edge, faces] : edge_to_faces) {
-        if (++checked > max_check) break;
-        
-        if (faces.size() == 1) {
-            // 边界边（总是特征边）
-            feature_edges_list.push_back(edge);
-        } else if (faces.size() == 2 && feature_edges_list.size() < 1000) {
-            // 计算二面角（限制数量）
-            int f1 = faces[0];
-            int f2 = faces[1];
-            double angle = computeDihedralAngle(V, F, f1, f2, edge.first, edge.second);
-            if (angle > feature_angle) {
-                feature_edges_list.push_back(edge);
-            }
+    // 先从端点和分叉点出发
+    for (int v = 0; v < topo.num_vertices; ++v) {
+        if (valence[v] == 0 || valence[v] == 2) continue;
+        for (HalfedgeIndex k = topo.vertex_edge_offsets[v]; k < topo.vertex_edge_offsets[v + 1]; ++k) {
+            const int e = topo.vertex_edges[k];
+            if (edges.test(e) && !visited.test(e)) walk(v, e);
         }
     }
     
-    // 简化：将所有特征边作为一个大的"边环"返回
-    if (!feature_edges_list.empty()) {
-        std::unordered_set<int> vertices_set;
-        vertices_set.reserve(feature_edges_list.size() * 2);
-        for (const auto& edge : feature_edges_list) {
-            vertices_set.insert(edge.first);
-            vertices_set.insert(edge.second);
-        }
-        if (vertices_set.size() >= 3) {
-            std::vector<int> loop(vertices_set.begin(), vertices_set.end());
-            edge_loops.push_back(loop);
-        }
+    // 剩下的边都在只含 2 度顶点的闭合环上
+    for (int e = 0; e < topo.numEdges(); ++e) {
+        if (edges.test(e) && !visited.test(e)) walk(topo.edges[e].v0, e);
     }
     
-    return edge_loops;
+    return loops;
+}
+
+template <typename DerivedV, typename DerivedF>
+std::vector<EdgeLoop> detectEdgeLoops(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    double feature_angle
+) {
+    return detectEdgeLoops(V, F, buildMeshTopology(V, F), feature_angle);
+}
+
+template <typename DerivedV, typename DerivedF>
+std::vector<EdgeLoop> detectEdgeLoops(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    double feature_angle
+) {
+    return chainFeatureEdges(topo, detectFeatureEdges(V, F, topo, feature_angle));
 }
 
+template <typename DerivedV, typename DerivedF>
 std::vector<UVIsland> segmentByEdgeLoops(
-    const Eigen::MatrixXd& V,
-    const Eigen::MatrixXi& F,
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
     const std::vector<std::vector<int>>& edge_loops
 ) {
-    std::vector<UVIsland> islands;
-    
-    // 优化：简单情况快速返回
-    if (edge_loops.empty()) {
-        UVIsland island;
-        island.faces.resize(F.rows());
-        for (int i = 0; i < F.rows(); ++i) island.faces[i] = i;
-        return {island};
-    }
-    
-    // 标记需要切割的边
-    std::set<Edge> cut_edges;
+    return toUVIslands(segmentByEdgeLoops(V, F, buildMeshTopology(V, F), edge_loops));
+}
+
+namespace {
+
+/**
+ * @brief 标记需要切割的边（按边 ID 的位集合；不是网格边的顶点对直接忽略）
+ */
+EdgeMask markLoopEdges(
+    const MeshTopology& topo,
+    const std::vector<std::vector<int>>& edge_loops
+) {
+    EdgeMask cut_edges(topo.numEdges());
     for (const auto& loop : edge_loops) {
         for (size_t i = 0; i < loop.size(); ++i) {
-            int v0 = loop[i];
-            int v1 = loop[(i + 1) % loop.size()];
-            cut_edges.insert(Edge(v0, v1));
+            int ei = topo.findEdge(loop[i], loop[(i + 1) % loop.size()]);
+            if (ei >= 0) cut_edges.set(ei);
         }
     }
-    
-    // 使用 BFS 分离 UV 岛
-    std::vector<int> face_to_island(F.rows(), -1);
-    int island_id = 0;
-    
-    // 优化：直接从面构建面邻接关系，不使用顶点邻接
-    struct PairHash {
-        size_t operator()(const std::pair<int,int>& p) const {
-            return std::hash<long long>()(((long long)p.first << 32) | p.second);
-        }
-    };
-    std::unordered_map<std::pair<int,int>, std::vector<int>, PairHash> edge_to_faces;
-    edge_to_faces.reserve(F.rows() * 3);
-    
-    for (int fi = 0; fi < F.rows(); ++fi) {
-        for (int i = 0; i < 3; ++i) {
-            int v0 = F(fi, i);
-            int v1 = F(fi, (i + 1) % 3);
-            if (v0 > v1) std::swap(v0, v1);
-            edge_to_faces[{v0, v1}].push_back(fi);
+    return cut_edges;
+}
+
+EdgeMask markLoopEdges(
+    const MeshTopology& topo,
+    const std::vector<EdgeLoop>& edge_loops
+) {
+    EdgeMask cut_edges(topo.numEdges());
+    for (const EdgeLoop& loop : edge_loops) {
+        for (int ei : loop.edges) {
+            if (ei >= 0 && ei < topo.numEdges()) cut_edges.set(ei);
         }
     }
+    return cut_edges;
+}
+
+} // namespace
+
+template <typename DerivedV, typename DerivedF>
+IslandSet segmentByCutEdges(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const EdgeMask& cut_edges,
+    const SegmentationOptions& options
+) {
+    // 划分 UV 岛（没有切割边时即为连通分量）
+    IslandSet islands = labelIslands(topo, cut_edges, options.labeling);
     
-    for (int start_face = 0; start_face < F.rows(); ++start_face) {
-        if (face_to_island[start_face] >= 0) continue;
-        
-        UVIsland island;
-        island.faces.reserve(1000);  // 预分配
-        
-        std::queue<int> queue;
-        queue.push(start_face);
-        face_to_island[start_face] = island_id;
-        
-        while (!queue.empty()) {
-            int current_face = queue.front();
-            queue.pop();
-            island.faces.push_back(current_face);
-            
-            // 检查这个面的3条边
-            for (int i = 0; i < 3; ++i) {
-                int v0 = F(current_face, i);
-                int v1 = F(current_face, (i + 1) % 3);
-                if (v0 > v1) std::swap(v0, v1);
-                Edge e(v0, v1);
-                
-                // 如果是切割边，标记为边界
-                if (cut_edges.count(e)) {
-                    island.boundary.push_back(e);
-                    continue;
-                }
-                
-                // 优化：直接从边查找相邻面
-                auto it = edge_to_faces.find({v0, v1});
-                if (it != edge_to_faces.end()) {
-                    for (int adj_face : it->second) {
-                        if (adj_face != current_face && face_to_island[adj_face] < 0) {
-                            queue.push(adj_face);
-                            face_to_island[adj_face] = island_id;
-                        }
-                    }
-                }
-            }
-        }
-        
-        // 计算岛的质心和面积
-        Eigen::MatrixXd BC;
-        igl::barycenter(V, F, BC);
-        
-        island.centroid = Eigen::Vector3d::Zero();
-        island.area = 0.0;
-        
-        Eigen::VectorXd areas;
-        igl::doublearea(V, F, areas);
-        areas /= 2.0;
-        
-        for (int fi : island.faces) {
-            island.centroid += BC.row(fi) * areas(fi);
-            island.area += areas(fi);
-        }
-        island.centroid /= island.area;
-        
-        islands.push_back(island);
-        ++island_id;
-    }
+    // 所有岛的质心和面积一趟算完；按需再统计岛之间的邻接
+    computeIslandStatistics(V, F, islands, options.geometry);
+    if (options.island_adjacency) buildIslandAdjacency(V, topo, islands, options.geometry);
     
     return islands;
 }
 
+template <typename DerivedV, typename DerivedF>
+IslandSet segmentByCutEdges(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const std::vector<int>& cut_edge_ids,
+    const SegmentationOptions& options
+) {
+    EdgeMask cut_edges(topo.numEdges());
+    for (int ei : cut_edge_ids) {
+        if (ei >= 0 && ei < topo.numEdges()) cut_edges.set(ei);
+    }
+    return segmentByCutEdges(V, F, topo, cut_edges, options);
+}
+
+template <typename DerivedV, typename DerivedF>
+void segmentByCutEdges(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const EdgeMask& cut_edges,
+    const IslandVisitor& visitor
+) {
+    // 面积、质心和包围盒在回调前逐岛累加
+    auto visit = [&](int id, const std::vector<int>& faces, const std::vector<Edge>& boundary) {
+        Eigen::Vector4d moment = Eigen::Vector4d::Zero();
+        Eigen::AlignedBox3d bounds;
+        for (int f : faces) {
+            moment += faceAreaMoment(V, F, f);
+            for (int i = 0; i < 3; ++i) bounds.extend(cornerPosition(V, F, f, i));
+        }
+        const Eigen::Vector3d centroid = moment(3) > 0
+            ? Eigen::Vector3d(moment.head<3>() / moment(3)) : Eigen::Vector3d::Zero();
+        visitor(IslandView{id, {faces.data(), faces.data() + faces.size()},
+                           {boundary.data(), boundary.data() + boundary.size()},
+                           centroid, moment(3), bounds.min(), bounds.max()});
+    };
+    
+    std::vector<int> face_to_island;
+    visitIslandsBreadthFirst(topo, cut_edges, face_to_island, visit);
+}
+
+template <typename DerivedV, typename DerivedF>
+IslandSet segmentByEdgeLoops(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const std::vector<std::vector<int>>& edge_loops,
+    const SegmentationOptions& options
+) {
+    return segmentByCutEdges(V, F, topo, markLoopEdges(topo, edge_loops), options);
+}
+
+template <typename DerivedV, typename DerivedF>
+void segmentByEdgeLoops(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const std::vector<std::vector<int>>& edge_loops,
+    const IslandVisitor& visitor
+) {
+    segmentByCutEdges(V, F, topo, markLoopEdges(topo, edge_loops), visitor);
+}
+
+template <typename DerivedV, typename DerivedF>
+std::vector<UVIsland> segmentByEdgeLoops(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const std::vector<EdgeLoop>& edge_loops
+) {
+    return toUVIslands(segmentByEdgeLoops(V, F, buildMeshTopology(V, F), edge_loops));
+}
+
+template <typename DerivedV, typename DerivedF>
+IslandSet segmentByEdgeLoops(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const std::vector<EdgeLoop>& edge_loops,
+    const SegmentationOptions& options
+) {
+    return segmentByCutEdges(V, F, topo, markLoopEdges(topo, edge_loops), options);
+}
+
+template <typename DerivedV, typename DerivedF>
+void segmentByEdgeLoops(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const std::vector<EdgeLoop>& edge_loops,
+    const IslandVisitor& visitor
+) {
+    segmentByCutEdges(V, F, topo, markLoopEdges(topo, edge_loops), visitor);
+}
+
+#define UV_SEGMENTATION_INSTANTIATE(DerivedV, DerivedF) \
+    template EdgeMask detectFeatureEdges<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const MeshTopology&, double); \
+    template std::vector<double> computeFeatureAngleEdgeWeights<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const MeshTopology&); \
+    template std::vector<EdgeLoop> detectEdgeLoops<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, double); \
+    template std::vector<EdgeLoop> detectEdgeLoops<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const MeshTopology&, double); \
+    template std::vector<UVIsland> segmentByEdgeLoops<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const std::vector<std::vector<int>>&); \
+    template IslandSet segmentByEdgeLoops<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const MeshTopology&, const std::vector<std::vector<int>>&, const SegmentationOptions&); \
+    template void segmentByEdgeLoops<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const MeshTopology&, const std::vector<std::vector<int>>&, const IslandVisitor&); \
+    template std::vector<UVIsland> segmentByEdgeLoops<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const std::vector<EdgeLoop>&); \
+    template IslandSet segmentByEdgeLoops<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const MeshTopology&, const std::vector<EdgeLoop>&, const SegmentationOptions&); \
+    template void segmentByEdgeLoops<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const MeshTopology&, const std::vector<EdgeLoop>&, const IslandVisitor&); \
+    template IslandSet segmentByCutEdges<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const MeshTopology&, const EdgeMask&, const SegmentationOptions&); \
+    template IslandSet segmentByCutEdges<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const MeshTopology&, const std::vector<int>&, const SegmentationOptions&); \
+    template void segmentByCutEdges<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const MeshTopology&, const EdgeMask&, const IslandVisitor&);
+UV_SEGMENTATION_MESH_TYPES(UV_SEGMENTATION_INSTANTIATE)
+#undef UV_SEGMENTATION_INSTANTIATE
+
 } // namespace UVSegmentation
@@ -0,0 +1,131 @@
+#include "uv_segmentation.h"
+#include "segmentation_internal.h"
+#include <igl/parallel_for.h>
+
+namespace UVSegmentation {
+
+FeatureAngleIndex buildFeatureAngleIndex(
+    const std::vector<double>& edge_angles
+) {
+    const int num_edges = static_cast<int>(edge_angles.size());
+    
+    // 键取反即为降序；稳定排序保证二面角相同时按边 ID 升序
+    FeatureAngleIndex index;
+    std::vector<uint64_t> keys(num_edges);
+    index.edges.resize(num_edges);
+    igl::parallel_for(num_edges, [&](int e) {
+        keys[e] = ~sortableKey(edge_angles[e]);
+        index.edges[e] = e;
+    }, 1 << 14);
+    radixSortPairs(keys, index.edges, 64);
+    
+    index.angles.resize(num_edges);
+    igl::parallel_for(num_edges, [&](int k) {
+        index.angles[k] = edge_angles[index.edges[k]];
+    }, 1 << 14);
+    
+    return index;
+}
+
+FeatureEdgeTracker::FeatureEdgeTracker(
+    const MeshTopology& topo,
+    const FeatureAngleIndex& index,
+    double feature_angle
+)
+    : topo_(&topo),
+      index_(&index),
+      feature_angle_(feature_angle),
+      feature_edges_(topo.numEdges()),
+      valence_(topo.num_vertices, 0),
+      edge_chain_(topo.numEdges(), -1) {
+    setFeatureAngle(feature_angle);
+}
+
+void FeatureEdgeTracker::setFeatureAngle(double feature_angle) {
+    const MeshTopology& topo = *topo_;
+    feature_angle_ = feature_angle;
+    
+    // 变化的边是索引中新旧前缀之间的一段
+    const int count = index_->countAbove(feature_angle);
+    if (count == num_features_) return;
+    const bool adding = count > num_features_;
+    const int begin = std::min(count, num_features_);
+    const int end = std::max(count, num_features_);
+    num_features_ = count;
+    
+    // 受影响的链：与变化的边共享顶点的链（被删除的边此时仍记录着所在的链）
+    std::vector<int> affected;
+    for (int k = begin; k < end; ++k) {
+        const Edge& edge = topo.edges[index_->edges[k]];
+        for (int v : {edge.v0, edge.v1}) {
+            for (HalfedgeIndex j = topo.vertex_edge_offsets[v]; j < topo.vertex_edge_offsets[v + 1]; ++j) {
+                const int chain = edge_chain_[topo.vertex_edges[j]];
+                if (chain >= 0) affected.push_back(chain);
+            }
+        }
+    }
+    std::sort(affected.begin(), affected.end());
+    affected.erase(std::unique(affected.begin(), affected.end()), affected.end());
+    
+    // 增删变化的边
+    std::vector<int> pending;
+    for (int k = begin; k < end; ++k) {
+        const int e = index_->edges[k];
+        const Edge& edge = topo.edges[e];
+        const int delta = adding ? 1 : -1;
+        valence_[edge.v0] += delta;
+        valence_[edge.v1] += delta;
+        if (adding) {
+            feature_edges_.set(e);
+            pending.push_back(e);
+        } else {
+            feature_edges_.reset(e);
+        }
+    }
+    
+    // 拆开受影响的链，其中仍是特征边的边待重新串联
+    for (int chain : affected) {
+        for (int e : chains_[chain].edges) {
+            edge_chain_[e] = -1;
+            if (feature_edges_.test(e)) pending.push_back(e);
+        }
+        chains_[chain] = EdgeLoop();
+        free_chains_.push_back(chain);
+    }
+    
+    // 其余链的顶点度数不变，仍是完整的链；待串联的边不会接到它们上面
+    int slot = -1;
+    auto isFree = [&](int e) { return feature_edges_.test(e) && edge_chain_[e] < 0; };
+    auto claim = [&](int e) { edge_chain_[e] = slot; };
+    auto walk = [&](int v, int e) {
+        if (free_chains_.empty()) {
+            slot = static_cast<int>(chains_.size());
+            chains_.emplace_back();
+        } else {
+            slot = free_chains_.back();
+            free_chains_.pop_back();
+        }
+        chains_[slot] = walkChain(topo, valence_, v, e, isFree, claim);
+    };
+    
+    // 与 chainFeatureEdges 相同：先从端点和分叉点出发，剩下的是纯 2 度闭合环
+    for (int e : pending) {
+        for (int v : {topo.edges[e].v0, topo.edges[e].v1}) {
+            if (valence_[v] != 2 && isFree(e)) walk(v, e);
+        }
+    }
+    for (int e : pending) {
+        if (isFree(e)) walk(topo.edges[e].v0, e);
+    }
+}
+
+std::vector<EdgeLoop> FeatureEdgeTracker::loops() const {
+    std::vector<EdgeLoop> result;
+    result.reserve(numLoops());
+    for (const EdgeLoop& chain : chains_) {
+        if (!chain.edges.empty()) result.push_back(chain);
+    }
+    return result;
+}
+
+} // namespace UVSegmentation
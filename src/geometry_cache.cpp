@@ -0,0 +1,83 @@
+#include "uv_segmentation.h"
+#include "segmentation_internal.h"
+#include <igl/parallel_for.h>
+
+namespace UVSegmentation {
+
+template <typename DerivedV, typename DerivedF>
+void computeFaceGeometry(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    GeometryCache& geometry
+) {
+    constexpr int kBlockSize = 256;
+    using Column = Eigen::Array<double, Eigen::Dynamic, 1, Eigen::ColMajor, kBlockSize, 1>;
+    
+    const int num_faces = static_cast<int>(F.rows());
+    geometry.normals.resize(num_faces, 3);
+    geometry.areas.resize(num_faces);
+    geometry.barycenters.resize(num_faces, 3);
+    
+    const int num_blocks = (num_faces + kBlockSize - 1) / kBlockSize;
+    igl::parallel_for(num_blocks, [&](int b) {
+        const int begin = b * kBlockSize;
+        const int n = std::min(kBlockSize, num_faces - begin);
+        
+        // 收集：p[c][a] 为块内各面第 c 个角的第 a 个坐标
+        Column p[3][3];
+        for (int c = 0; c < 3; ++c) {
+            for (int a = 0; a < 3; ++a) p[c][a].resize(n);
+        }
+        for (int j = 0; j < n; ++j) {
+            for (int c = 0; c < 3; ++c) {
+                const auto row = V.row(F(begin + j, c));
+                for (int a = 0; a < 3; ++a) p[c][a](j) = static_cast<double>(row(a));
+            }
+        }
+        
+        // 以下均为逐元素运算
+        const Column ux = p[1][0] - p[0][0], uy = p[1][1] - p[0][1], uz = p[1][2] - p[0][2];
+        const Column vx = p[2][0] - p[0][0], vy = p[2][1] - p[0][1], vz = p[2][2] - p[0][2];
+        const Column nx = uy * vz - uz * vy;
+        const Column ny = uz * vx - ux * vz;
+        const Column nz = ux * vy - uy * vx;
+        const Column length = (nx.square() + ny.square() + nz.square()).sqrt();
+        const Column inverse = (length > 0).select(length.inverse(), Column::Zero(n));
+        
+        geometry.normals.col(0).segment(begin, n) = (nx * inverse).matrix();
+        geometry.normals.col(1).segment(begin, n) = (ny * inverse).matrix();
+        geometry.normals.col(2).segment(begin, n) = (nz * inverse).matrix();
+        geometry.areas.segment(begin, n) = (0.5 * length).matrix();
+        for (int a = 0; a < 3; ++a) {
+            geometry.barycenters.col(a).segment(begin, n) = ((p[0][a] + p[1][a] + p[2][a]) / 3.0).matrix();
+        }
+    }, 1);
+}
+
+template <typename DerivedV, typename DerivedF>
+GeometryCache buildGeometryCache(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo
+) {
+    GeometryCache geometry;
+    computeFaceGeometry(V, F, geometry);
+    
+    geometry.edge_lengths.resize(topo.numEdges());
+    igl::parallel_for(topo.numEdges(), [&](int e) {
+        const Edge& edge = topo.edges[e];
+        geometry.edge_lengths[e] = (V.row(edge.v0) - V.row(edge.v1)).template cast<double>().norm();
+    }, 1 << 12);
+    
+    return geometry;
+}
+
+#define UV_SEGMENTATION_INSTANTIATE(DerivedV, DerivedF) \
+    template void computeFaceGeometry<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, GeometryCache&); \
+    template GeometryCache buildGeometryCache<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, const MeshTopology&);
+UV_SEGMENTATION_MESH_TYPES(UV_SEGMENTATION_INSTANTIATE)
+#undef UV_SEGMENTATION_INSTANTIATE
+
+} // namespace UVSegmentation
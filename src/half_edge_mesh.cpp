@@ -0,0 +1,107 @@
+#include "uv_segmentation.h"
+#include "segmentation_internal.h"
+#include <igl/parallel_for.h>
+
+namespace UVSegmentation {
+
+template <typename DerivedF>
+void buildHalfEdges(const Eigen::MatrixBase<DerivedF>& F, MeshTopology& topo) {
+    HalfEdgeMesh& mesh = topo.halfedges;
+    const int num_faces = static_cast<int>(F.rows());
+    const HalfedgeIndex num_interior = MeshTopology::corner(num_faces, 0);
+    const int num_edges = topo.numEdges();
+    
+    auto origin = [&](HalfedgeIndex h) { return static_cast<int>(F(h / 3, h % 3)); };
+    auto target = [&](HalfedgeIndex h) { return static_cast<int>(F(h / 3, (h % 3 + 1) % 3)); };
+    
+    // 边 -> 内部半边（与 edge_faces 共用 CSR 偏移，段内按半边索引升序）
+    std::vector<HalfedgeIndex> edge_halfedges(num_interior);
+    std::vector<HalfedgeIndex> cursor(topo.edge_face_offsets.begin(), topo.edge_face_offsets.end() - 1);
+    for (HalfedgeIndex h = 0; h < num_interior; ++h) {
+        edge_halfedges[cursor[topo.face_edges[h]]++] = h;
+    }
+    
+    // 只有恰好两条方向相反的半边才配对，其余都补一条边界半边
+    mesh.twin.assign(num_interior, -1);
+    igl::parallel_for(num_edges, [&](int e) {
+        if (topo.edgeFaceCount(e) != 2) return;
+        
+        const HalfedgeIndex h0 = edge_halfedges[topo.edge_face_offsets[e]];
+        const HalfedgeIndex h1 = edge_halfedges[topo.edge_face_offsets[e] + 1];
+        if (origin(h0) == target(h1) && origin(h1) == target(h0) && origin(h0) != target(h0)) {
+            mesh.twin[h0] = h1;
+            mesh.twin[h1] = h0;
+        }
+    }, 1 << 12);
+    
+    HalfedgeIndex num_halfedges = num_interior;
+    for (HalfedgeIndex h = 0; h < num_interior; ++h) {
+        if (mesh.twin[h] < 0) mesh.twin[h] = num_halfedges++;
+    }
+    
+    mesh.twin.resize(num_halfedges);
+    mesh.next.resize(num_halfedges);
+    mesh.vertex.resize(num_halfedges);
+    mesh.face.resize(num_halfedges);
+    mesh.edge.resize(num_halfedges);
+    
+    igl::parallel_for(num_faces, [&](int f) {
+        for (int i = 0; i < 3; ++i) {
+            const HalfedgeIndex h = MeshTopology::corner(f, i);
+            mesh.next[h] = MeshTopology::corner(f, (i + 1) % 3);
+            mesh.vertex[h] = static_cast<int>(F(f, i));
+            mesh.face[h] = f;
+            mesh.edge[h] = topo.face_edges[h];
+            
+            const HalfedgeIndex b = mesh.twin[h];
+            if (b >= num_interior) {
+                mesh.twin[b] = h;
+                mesh.vertex[b] = target(h);
+                mesh.face[b] = -1;
+                mesh.edge[b] = topo.face_edges[h];
+            }
+        }
+    }, 1 << 12);
+    
+    // 边界半边 b (v -> u) 的下一条是从 u 出发的边界半边：
+    // 从 twin(b) = (u -> v) 开始绕 u 旋转，直到遇到边界半边
+    igl::parallel_for(num_halfedges - num_interior, [&](HalfedgeIndex k) {
+        const HalfedgeIndex b = num_interior + k;
+        HalfedgeIndex g = mesh.twin[b];
+        do {
+            const HalfedgeIndex prev = g - g % 3 + (g % 3 + 2) % 3;
+            g = mesh.twin[prev];
+        } while (mesh.face[g] >= 0);
+        mesh.next[b] = g;
+    }, 1 << 12);
+    
+    // 顶点出半边：边界顶点优先取边界出半边，一环遍历从扇区一端开始
+    mesh.vertex_halfedge.assign(topo.num_vertices, -1);
+    for (HalfedgeIndex h = 0; h < num_interior; ++h) {
+        mesh.vertex_halfedge[mesh.vertex[h]] = h;
+    }
+    for (HalfedgeIndex b = num_interior; b < num_halfedges; ++b) {
+        mesh.vertex_halfedge[mesh.vertex[b]] = b;
+    }
+}
+
+template <typename DerivedV, typename DerivedF>
+HalfEdgeMesh buildHalfEdgeMesh(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F
+) {
+    return std::move(buildMeshTopology(V, F).halfedges);
+}
+
+#define UV_SEGMENTATION_INSTANTIATE(DerivedF) \
+    template void buildHalfEdges<DerivedF>(const Eigen::MatrixBase<DerivedF>&, MeshTopology&);
+UV_SEGMENTATION_FACE_TYPES(UV_SEGMENTATION_INSTANTIATE)
+#undef UV_SEGMENTATION_INSTANTIATE
+
+#define UV_SEGMENTATION_INSTANTIATE(DerivedV, DerivedF) \
+    template HalfEdgeMesh buildHalfEdgeMesh<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&);
+UV_SEGMENTATION_MESH_TYPES(UV_SEGMENTATION_INSTANTIATE)
+#undef UV_SEGMENTATION_INSTANTIATE
+
+} // namespace UVSegmentation
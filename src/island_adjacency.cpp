@@ -0,0 +1,128 @@
+#include "uv_segmentation.h"
+#include "segmentation_internal.h"
+#include <igl/parallel_for.h>
+
+namespace UVSegmentation {
+
+template <typename DerivedV>
+void buildIslandAdjacency(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const MeshTopology& topo,
+    IslandSet& islands,
+    const GeometryCache* geometry
+) {
+    const int num_edges = topo.numEdges();
+    const int num_islands = islands.numIslands();
+    
+    int island_bits = 1;
+    while ((int64_t(1) << island_bits) < num_islands) ++island_bits;
+    
+    // 对边 e 上每个不同的岛对 (a < b) 调用 emit；流形边只有一对面
+    auto forEachPair = [&](int e, auto&& emit) {
+        const HalfedgeIndex begin = topo.edge_face_offsets[e];
+        const HalfedgeIndex end = topo.edge_face_offsets[e + 1];
+        if (end - begin == 2) {
+            const int a = islands.face_island[topo.edge_faces[begin]];
+            const int b = islands.face_island[topo.edge_faces[begin + 1]];
+            if (a != b) emit(std::min(a, b), std::max(a, b));
+            return;
+        }
+        if (end - begin < 2) return;
+        
+        // 非流形边：同一岛对只计一次
+        std::vector<int> edge_islands;
+        for (HalfedgeIndex k = begin; k < end; ++k) {
+            edge_islands.push_back(islands.face_island[topo.edge_faces[k]]);
+        }
+        std::sort(edge_islands.begin(), edge_islands.end());
+        edge_islands.erase(std::unique(edge_islands.begin(), edge_islands.end()), edge_islands.end());
+        for (size_t i = 0; i < edge_islands.size(); ++i) {
+            for (size_t j = i + 1; j < edge_islands.size(); ++j) emit(edge_islands[i], edge_islands[j]);
+        }
+    };
+    
+    // 按块计数、前缀求和后按块写入 (岛对键, 边 ID)，再按岛对稳定排序
+    const Chunks chunks(num_edges);
+    std::vector<int> chunk_offsets(chunks.count + 1, 0);
+    igl::parallel_for(static_cast<int>(chunks.count), [&](int c) {
+        int count = 0;
+        for (size_t e = chunks.begin(c, num_edges); e < chunks.end(c, num_edges); ++e) {
+            forEachPair(static_cast<int>(e), [&](int, int) { ++count; });
+        }
+        chunk_offsets[c + 1] = count;
+    }, 1);
+    for (size_t c = 0; c < chunks.count; ++c) {
+        chunk_offsets[c + 1] += chunk_offsets[c];
+    }
+    
+    const int num_entries = chunk_offsets[chunks.count];
+    std::vector<uint64_t> keys(num_entries);
+    std::vector<int> edge_ids(num_entries);
+    igl::parallel_for(static_cast<int>(chunks.count), [&](int c) {
+        int out = chunk_offsets[c];
+        for (size_t e = chunks.begin(c, num_edges); e < chunks.end(c, num_edges); ++e) {
+            forEachPair(static_cast<int>(e), [&](int a, int b) {
+                keys[out] = (static_cast<uint64_t>(a) << island_bits) | static_cast<uint64_t>(b);
+                edge_ids[out] = static_cast<int>(e);
+                ++out;
+            });
+        }
+    }, 1);
+    radixSortPairs(keys, edge_ids, 2 * island_bits);
+    
+    // 相同岛对的一段合并为一条无向边；边长按边 ID 顺序累加
+    struct Pair {
+        int a;
+        int b;
+        int edges;
+        double length;
+    };
+    std::vector<Pair> pairs;
+    const uint64_t island_mask = (uint64_t(1) << island_bits) - 1;
+    for (int k = 0; k < num_entries; ++k) {
+        const Edge& edge = topo.edges[edge_ids[k]];
+        const double length = geometry
+            ? geometry->edge_lengths[edge_ids[k]]
+            : (V.row(edge.v0) - V.row(edge.v1)).template cast<double>().norm();
+        if (k > 0 && keys[k] == keys[k - 1]) {
+            pairs.back().edges += 1;
+            pairs.back().length += length;
+        } else {
+            pairs.push_back({static_cast<int>(keys[k] >> island_bits),
+                             static_cast<int>(keys[k] & island_mask), 1, length});
+        }
+    }
+    
+    // 对称 CSR：岛对按 (a, b) 升序，依次写入两行后每行自然按邻岛 ID 升序
+    islands.neighbor_offsets.assign(num_islands + 1, 0);
+    for (const Pair& p : pairs) {
+        ++islands.neighbor_offsets[p.a + 1];
+        ++islands.neighbor_offsets[p.b + 1];
+    }
+    for (int i = 0; i < num_islands; ++i) {
+        islands.neighbor_offsets[i + 1] += islands.neighbor_offsets[i];
+    }
+    
+    const int num_neighbors = islands.neighbor_offsets[num_islands];
+    islands.neighbors.resize(num_neighbors);
+    islands.shared_edges.resize(num_neighbors);
+    islands.shared_lengths.resize(num_neighbors);
+    std::vector<int> cursor(islands.neighbor_offsets.begin(), islands.neighbor_offsets.end() - 1);
+    for (const Pair& p : pairs) {
+        for (int side = 0; side < 2; ++side) {
+            const int from = side ? p.b : p.a;
+            const int k = cursor[from]++;
+            islands.neighbors[k] = side ? p.a : p.b;
+            islands.shared_edges[k] = p.edges;
+            islands.shared_lengths[k] = p.length;
+        }
+    }
+}
+
+#define UV_SEGMENTATION_INSTANTIATE(DerivedV) \
+    template void buildIslandAdjacency<DerivedV>( \
+        const Eigen::MatrixBase<DerivedV>&, const MeshTopology&, IslandSet&, const GeometryCache*);
+UV_SEGMENTATION_VERTEX_TYPES(UV_SEGMENTATION_INSTANTIATE)
+#undef UV_SEGMENTATION_INSTANTIATE
+
+} // namespace UVSegmentation
@@ -0,0 +1,350 @@
+#include "uv_segmentation.h"
+#include "segmentation_internal.h"
+#include <igl/default_num_threads.h>
+#include <igl/parallel_for.h>
+#include <atomic>
+
+namespace UVSegmentation {
+
+namespace {
+
+constexpr int kMinParallelFaces = 1 << 16;  // Automatic 切换到并查集的面数
+
+/**
+ * @brief 无锁并查集
+ * 
+ * 合并时总是把较大的根挂到较小的根下（CAS），因此 parent[x] <= x 恒成立，
+ * 每个分量的根就是其最小元素，与合并顺序无关。查找使用路径减半。
+ */
+class ConcurrentUnionFind {
+public:
+    explicit ConcurrentUnionFind(int n) : parent_(n) {
+        igl::parallel_for(n, [&](int i) {
+            parent_[i].store(i, std::memory_order_relaxed);
+        }, 1 << 14);
+    }
+    
+    int find(int x) {
+        while (true) {
+            int p = parent_[x].load(std::memory_order_relaxed);
+            if (p == x) return x;
+            const int grandparent = parent_[p].load(std::memory_order_relaxed);
+            if (grandparent != p) {
+                parent_[x].compare_exchange_weak(p, grandparent, std::memory_order_relaxed);
+            }
+            x = grandparent;
+        }
+    }
+    
+    void unite(int a, int b) {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return;
+            if (a > b) std::swap(a, b);
+            int expected = b;
+            if (parent_[b].compare_exchange_strong(expected, a)) return;
+        }
+    }
+
+private:
+    std::vector<std::atomic<int>> parent_;
+};
+
+/**
+ * @brief 串行 BFS 求面标签，CSR 与并查集共用 islandsFromRoots 生成
+ * 
+ * 每个岛的 BFS 起点是其最小面，即并查集得到的根，因此两种算法的输出完全相同。
+ */
+IslandSet labelIslandsBreadthFirst(
+    const MeshTopology& topo,
+    const EdgeMask& cut_edges
+) {
+    std::vector<int> face_island;
+    std::vector<int> island_root;
+    visitIslandsBreadthFirst(topo, cut_edges, face_island,
+        [&](int, const std::vector<int>& faces, const std::vector<Edge>&) {
+            island_root.push_back(faces.front());
+        });
+    
+    std::vector<int> root(topo.num_faces);
+    igl::parallel_for(topo.num_faces, [&](int f) {
+        root[f] = island_root[face_island[f]];
+    }, 1 << 12);
+    
+    return islandsFromRoots(topo, cut_edges, root);
+}
+
+/**
+ * @brief 并行无锁并查集
+ * 
+ * 对每条非切割边并行合并其上的面，再由 islandsFromRoots 生成 CSR。
+ */
+IslandSet labelIslandsUnionFind(
+    const MeshTopology& topo,
+    const EdgeMask& cut_edges
+) {
+    const int num_faces = topo.num_faces;
+    
+    ConcurrentUnionFind components(num_faces);
+    igl::parallel_for(topo.numEdges(), [&](int e) {
+        if (cut_edges.test(e)) return;
+        const HalfedgeIndex begin = topo.edge_face_offsets[e];
+        const HalfedgeIndex end = topo.edge_face_offsets[e + 1];
+        for (HalfedgeIndex k = begin + 1; k < end; ++k) {
+            components.unite(topo.edge_faces[begin], topo.edge_faces[k]);
+        }
+    }, 1 << 12);
+    
+    std::vector<int> root(num_faces);
+    igl::parallel_for(num_faces, [&](int f) {
+        root[f] = components.find(f);
+    }, 1 << 12);
+    
+    return islandsFromRoots(topo, cut_edges, root);
+}
+
+} // namespace
+
+IslandSet islandsFromRoots(
+    const MeshTopology& topo,
+    const EdgeMask& cut_edges,
+    const std::vector<int>& root
+) {
+    const int num_faces = topo.num_faces;
+    IslandSet islands;
+    
+    // 根 -> 岛 ID
+    const Chunks chunks(num_faces);
+    std::vector<int> chunk_offsets(chunks.count + 1, 0);
+    igl::parallel_for(static_cast<int>(chunks.count), [&](int c) {
+        int count = 0;
+        for (size_t f = chunks.begin(c, num_faces); f < chunks.end(c, num_faces); ++f) {
+            if (root[f] == static_cast<int>(f)) ++count;
+        }
+        chunk_offsets[c + 1] = count;
+    }, 1);
+    for (size_t c = 0; c < chunks.count; ++c) {
+        chunk_offsets[c + 1] += chunk_offsets[c];
+    }
+    const int num_islands = chunk_offsets[chunks.count];
+    
+    std::vector<int> root_island(num_faces, -1);
+    igl::parallel_for(static_cast<int>(chunks.count), [&](int c) {
+        int id = chunk_offsets[c];
+        for (size_t f = chunks.begin(c, num_faces); f < chunks.end(c, num_faces); ++f) {
+            if (root[f] == static_cast<int>(f)) root_island[f] = id++;
+        }
+    }, 1);
+    
+    // 按岛 ID 稳定排序面索引
+    islands.face_island.resize(num_faces);
+    islands.faces.resize(num_faces);
+    std::vector<uint64_t> keys(num_faces);
+    igl::parallel_for(num_faces, [&](int f) {
+        islands.face_island[f] = root_island[root[f]];
+        keys[f] = static_cast<uint64_t>(islands.face_island[f]);
+        islands.faces[f] = f;
+    }, 1 << 12);
+    int key_bits = 1;
+    while ((int64_t(1) << key_bits) < num_islands) ++key_bits;
+    radixSortPairs(keys, islands.faces, key_bits);
+    
+    // 边界边：按面 CSR 顺序逐块计数，再按块顺序写入
+    std::vector<HalfedgeIndex> chunk_boundary(chunks.count + 1, 0);
+    igl::parallel_for(static_cast<int>(chunks.count), [&](int c) {
+        HalfedgeIndex count = 0;
+        for (size_t k = chunks.begin(c, num_faces); k < chunks.end(c, num_faces); ++k) {
+            for (int j = 0; j < 3; ++j) {
+                if (cut_edges.test(topo.faceEdge(islands.faces[k], j))) ++count;
+            }
+        }
+        chunk_boundary[c + 1] = count;
+    }, 1);
+    for (size_t c = 0; c < chunks.count; ++c) {
+        chunk_boundary[c + 1] += chunk_boundary[c];
+    }
+    
+    islands.face_offsets.assign(num_islands + 1, num_faces);
+    islands.boundary_offsets.assign(num_islands + 1, chunk_boundary[chunks.count]);
+    islands.boundary.resize(chunk_boundary[chunks.count]);
+    igl::parallel_for(static_cast<int>(chunks.count), [&](int c) {
+        HalfedgeIndex out = chunk_boundary[c];
+        for (size_t k = chunks.begin(c, num_faces); k < chunks.end(c, num_faces); ++k) {
+            if (k == 0 || keys[k] != keys[k - 1]) {
+                islands.face_offsets[keys[k]] = static_cast<int>(k);
+                islands.boundary_offsets[keys[k]] = out;
+            }
+            for (int j = 0; j < 3; ++j) {
+                const int ei = topo.faceEdge(islands.faces[k], j);
+                if (cut_edges.test(ei)) islands.boundary[out++] = topo.edges[ei];
+            }
+        }
+    }, 1);
+    islands.cut_edges = cut_edges;
+    
+    return islands;
+}
+
+void visitIslandsBreadthFirst(
+    const MeshTopology& topo,
+    const EdgeMask& cut_edges,
+    std::vector<int>& face_to_island,
+    const IslandFaceVisitor& visit
+) {
+    face_to_island.assign(topo.num_faces, -1);
+    std::vector<int> faces;
+    std::vector<Edge> boundary;
+    int island_id = 0;
+    
+    for (int start_face = 0; start_face < topo.num_faces; ++start_face) {
+        if (face_to_island[start_face] >= 0) continue;
+        
+        // faces 同时充当 BFS 队列：head 之前为已处理的面
+        faces.clear();
+        boundary.clear();
+        faces.push_back(start_face);
+        face_to_island[start_face] = island_id;
+        
+        for (size_t head = 0; head < faces.size(); ++head) {
+            const int current_face = faces[head];
+            
+            // 检查这个面的3条边
+            for (int i = 0; i < 3; ++i) {
+                const int ei = topo.faceEdge(current_face, i);
+                
+                // 如果是切割边，标记为边界
+                if (cut_edges.test(ei)) {
+                    boundary.push_back(topo.edges[ei]);
+                    continue;
+                }
+                
+                const int adj_face = topo.faceNeighbor(current_face, i);
+                if (adj_face >= 0) {
+                    if (face_to_island[adj_face] < 0) {
+                        faces.push_back(adj_face);
+                        face_to_island[adj_face] = island_id;
+                    }
+                } else if (adj_face == MeshTopology::kNonManifold) {
+                    // 非流形边：回退到边-面 CSR
+                    for (HalfedgeIndex k = topo.edge_face_offsets[ei]; k < topo.edge_face_offsets[ei + 1]; ++k) {
+                        int other = topo.edge_faces[k];
+                        if (face_to_island[other] < 0) {
+                            faces.push_back(other);
+                            face_to_island[other] = island_id;
+                        }
+                    }
+                }
+            }
+        }
+        
+        visit(island_id, faces, boundary);
+        ++island_id;
+    }
+}
+
+IslandSet labelIslands(
+    const MeshTopology& topo,
+    const EdgeMask& cut_edges,
+    IslandLabeling labeling
+) {
+    if (labeling == IslandLabeling::Automatic) {
+        labeling = (topo.num_faces >= kMinParallelFaces && igl::default_num_threads() > 1) ?
+                   IslandLabeling::UnionFind : IslandLabeling::BreadthFirst;
+    }
+    
+    IslandSet islands = (labeling == IslandLabeling::UnionFind) ?
+                        labelIslandsUnionFind(topo, cut_edges) :
+                        labelIslandsBreadthFirst(topo, cut_edges);
+    traceBoundaryLoops(topo, cut_edges, islands);
+    return islands;
+}
+
+void traceBoundaryLoops(
+    const MeshTopology& topo,
+    const EdgeMask& cut_edges,
+    IslandSet& islands
+) {
+    const HalfEdgeMesh& mesh = topo.halfedges;
+    const int num_islands = islands.numIslands();
+    
+    auto isBoundary = [&](HalfedgeIndex h) {
+        const int opposite = mesh.face[mesh.twin[h]];
+        return opposite < 0 || islands.face_island[opposite] != islands.face_island[mesh.face[h]] ||
+               cut_edges.test(mesh.edge[h]);
+    };
+    
+    // 绕 h 的终点旋转，直到遇到下一条边界半边
+    auto nextBoundary = [&](HalfedgeIndex h) {
+        HalfedgeIndex g = mesh.next[h];
+        while (!isBoundary(g)) g = mesh.next[mesh.twin[g]];
+        return g;
+    };
+    
+    // 各岛只访问自己的面的半边，visited 按岛互不重叠
+    std::vector<char> visited(MeshTopology::corner(topo.num_faces, 0), 0);
+    std::vector<std::vector<HalfedgeIndex>> island_loop_sizes(num_islands);
+    std::vector<std::vector<int>> island_vertices(num_islands);
+    igl::parallel_for(num_islands, [&](int i) {
+        for (int f : islands.islandFaces(i)) {
+            for (int j = 0; j < 3; ++j) {
+                const HalfedgeIndex start = MeshTopology::corner(f, j);
+                if (visited[start] || !isBoundary(start)) continue;
+                
+                HalfedgeIndex h = start;
+                HalfedgeIndex length = 0;
+                do {
+                    visited[h] = 1;
+                    island_vertices[i].push_back(mesh.vertex[h]);
+                    ++length;
+                    h = nextBoundary(h);
+                } while (!visited[h]);  // 正常情况下回到 start；非流形顶点处提前结束
+                island_loop_sizes[i].push_back(length);
+            }
+        }
+    }, 1 << 8);
+    
+    // 按岛顺序拼接为 CSR
+    islands.island_loop_offsets.assign(num_islands + 1, 0);
+    for (int i = 0; i < num_islands; ++i) {
+        islands.island_loop_offsets[i + 1] =
+            islands.island_loop_offsets[i] + static_cast<int>(island_loop_sizes[i].size());
+    }
+    const int num_loops = islands.island_loop_offsets[num_islands];
+    
+    islands.loop_offsets.assign(num_loops + 1, 0);
+    for (int i = 0; i < num_islands; ++i) {
+        int loop = islands.island_loop_offsets[i];
+        for (HalfedgeIndex size : island_loop_sizes[i]) {
+            islands.loop_offsets[loop + 1] = islands.loop_offsets[loop] + size;
+            ++loop;
+        }
+    }
+    
+    islands.loop_vertices.resize(islands.loop_offsets[num_loops]);
+    igl::parallel_for(num_islands, [&](int i) {
+        const int first = islands.island_loop_offsets[i];
+        std::copy(island_vertices[i].begin(), island_vertices[i].end(),
+                  islands.loop_vertices.begin() + islands.loop_offsets[first]);
+    }, 1 << 8);
+}
+
+std::vector<UVIsland> toUVIslands(const IslandSet& islands) {
+    std::vector<UVIsland> result(islands.numIslands());
+    igl::parallel_for(islands.numIslands(), [&](int i) {
+        const ConstSpan<int> faces = islands.islandFaces(i);
+        const ConstSpan<Edge> boundary = islands.islandBoundary(i);
+        result[i].faces.assign(faces.begin(), faces.end());
+        result[i].boundary.assign(boundary.begin(), boundary.end());
+        result[i].boundary_loops.resize(islands.numLoops(i));
+        for (int k = 0; k < islands.numLoops(i); ++k) {
+            const ConstSpan<int> loop = islands.islandLoop(i, k);
+            result[i].boundary_loops[k].assign(loop.begin(), loop.end());
+        }
+        result[i].centroid = islands.centroids[i];
+        result[i].area = islands.areas[i];
+    }, 1 << 8);
+    return result;
+}
+
+} // namespace UVSegmentation
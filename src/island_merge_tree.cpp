@@ -0,0 +1,134 @@
+#include "uv_segmentation.h"
+#include "segmentation_internal.h"
+#include <igl/parallel_for.h>
+
+namespace UVSegmentation {
+
+namespace {
+
+/**
+ * @brief 阈值下每个面所在分量的根（分量中的最小面）
+ */
+std::vector<int> componentRoots(const IslandMergeTree& tree, double threshold) {
+    const int num_faces = tree.num_faces;
+    const int num_merges = tree.numMerges();
+    
+    // 合并节点的父节点编号更大、权重不降，自顶向下找到权重不超过阈值的最高祖先
+    std::vector<int> top(num_merges);
+    for (int m = num_merges - 1; m >= 0; --m) {
+        const int p = tree.parent[num_faces + m];
+        top[m] = (p >= 0 && tree.merge_weights[p - num_faces] <= threshold) ? top[p - num_faces] : m;
+    }
+    
+    std::vector<int> root(num_faces);
+    igl::parallel_for(num_faces, [&](int f) {
+        const int p = tree.parent[f];
+        root[f] = (p >= 0 && tree.merge_weights[p - num_faces] <= threshold)
+            ? tree.min_face[top[p - num_faces]] : f;
+    }, 1 << 12);
+    return root;
+}
+
+} // namespace
+
+IslandMergeTree buildIslandMergeTree(
+    const MeshTopology& topo,
+    const std::vector<double>& edge_weights
+) {
+    const int num_faces = topo.num_faces;
+    const int num_edges = topo.numEdges();
+    
+    IslandMergeTree tree;
+    tree.num_faces = num_faces;
+    tree.edge_weights = edge_weights;
+    tree.parent.assign(num_faces, -1);
+    
+    // 按权重升序稳定排序边：double 的位模式翻转后按无符号整数比较即为数值顺序
+    std::vector<uint64_t> keys(num_edges);
+    std::vector<int> order(num_edges);
+    igl::parallel_for(num_edges, [&](int e) {
+        keys[e] = sortableKey(edge_weights[e]);
+        order[e] = e;
+    }, 1 << 14);
+    radixSortPairs(keys, order, 64);
+    
+    // Kruskal：每次合并两个分量都新建一个节点，记录合并权重和子树中的最小面
+    DisjointSets components(num_faces);
+    std::vector<int> component_node(num_faces);
+    for (int f = 0; f < num_faces; ++f) component_node[f] = f;
+    
+    auto minFace = [&](int node) {
+        return node < num_faces ? node : tree.min_face[node - num_faces];
+    };
+    
+    for (int e : order) {
+        const HalfedgeIndex begin = topo.edge_face_offsets[e];
+        const HalfedgeIndex end = topo.edge_face_offsets[e + 1];
+        for (HalfedgeIndex k = begin + 1; k < end; ++k) {
+            const int a = components.find(topo.edge_faces[begin]);
+            const int b = components.find(topo.edge_faces[k]);
+            if (a == b) continue;
+            
+            const int node = num_faces + tree.numMerges();
+            const int node_a = component_node[a];
+            const int node_b = component_node[b];
+            tree.parent[node_a] = node;
+            tree.parent[node_b] = node;
+            tree.parent.push_back(-1);
+            tree.merge_weights.push_back(edge_weights[e]);
+            tree.min_face.push_back(std::min(minFace(node_a), minFace(node_b)));
+            component_node[components.unite(a, b)] = node;
+        }
+    }
+    
+    return tree;
+}
+
+std::vector<int> faceIslandsAtThreshold(
+    const IslandMergeTree& tree,
+    double threshold
+) {
+    // 根不大于面本身，按面升序编号即得按最小面排序的岛 ID
+    std::vector<int> face_island = componentRoots(tree, threshold);
+    int num_islands = 0;
+    for (int f = 0; f < tree.num_faces; ++f) {
+        face_island[f] = (face_island[f] == f) ? num_islands++ : face_island[face_island[f]];
+    }
+    return face_island;
+}
+
+template <typename DerivedV, typename DerivedF>
+IslandSet islandsAtThreshold(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const IslandMergeTree& tree,
+    double threshold,
+    const SegmentationOptions& options
+) {
+    EdgeMask cut_edges(topo.numEdges());
+    igl::parallel_for(cut_edges.numWords(), [&](int w) {
+        uint64_t word = 0;
+        const int end = std::min(topo.numEdges(), (w + 1) * 64);
+        for (int e = w * 64; e < end; ++e) {
+            if (tree.edge_weights[e] > threshold) word |= uint64_t(1) << (e & 63);
+        }
+        cut_edges.word(w) = word;
+    }, 1 << 8);
+    
+    IslandSet islands = islandsFromRoots(topo, cut_edges, componentRoots(tree, threshold));
+    traceBoundaryLoops(topo, cut_edges, islands);
+    computeIslandStatistics(V, F, islands, options.geometry);
+    if (options.island_adjacency) buildIslandAdjacency(V, topo, islands, options.geometry);
+    
+    return islands;
+}
+
+#define UV_SEGMENTATION_INSTANTIATE(DerivedV, DerivedF) \
+    template IslandSet islandsAtThreshold<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const MeshTopology&, const IslandMergeTree&, double, const SegmentationOptions&);
+UV_SEGMENTATION_MESH_TYPES(UV_SEGMENTATION_INSTANTIATE)
+#undef UV_SEGMENTATION_INSTANTIATE
+
+} // namespace UVSegmentation
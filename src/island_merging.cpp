@@ -0,0 +1,213 @@
+#include "uv_segmentation.h"
+#include "segmentation_internal.h"
+#include <igl/parallel_for.h>
+#include <queue>
+
+namespace UVSegmentation {
+
+template <typename DerivedV, typename DerivedF>
+IslandSet mergeSmallIslands(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const IslandSet& islands,
+    double min_area,
+    int min_faces,
+    const SegmentationOptions& options
+) {
+    // 合并需要邻接图：输入没有时在副本上构建
+    IslandSet with_adjacency;
+    if (!islands.hasAdjacency()) {
+        with_adjacency = islands;
+        buildIslandAdjacency(V, topo, with_adjacency, options.geometry);
+    }
+    const IslandSet& source = islands.hasAdjacency() ? islands : with_adjacency;
+    const int num_islands = source.numIslands();
+    
+    std::vector<double> area(source.areas);
+    std::vector<int> face_count(num_islands);
+    for (int i = 0; i < num_islands; ++i) {
+        face_count[i] = islands.face_offsets[i + 1] - islands.face_offsets[i];
+    }
+    auto isSmall = [&](int r) { return area[r] < min_area || face_count[r] < min_faces; };
+    
+    // 每个根的邻接表 (邻岛, 共享长度)；邻岛可能已被合并，使用时经 find 归到根
+    std::vector<std::vector<std::pair<int, double>>> adjacency(num_islands);
+    for (int i = 0; i < num_islands; ++i) {
+        for (int k = source.neighbor_offsets[i]; k < source.neighbor_offsets[i + 1]; ++k) {
+            adjacency[i].emplace_back(source.neighbors[k], source.shared_lengths[k]);
+        }
+    }
+    
+    // 面积最小堆；合并后面积变化的根重新入堆，过期项出堆时跳过
+    using Entry = std::pair<double, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+    for (int i = 0; i < num_islands; ++i) {
+        if (isSmall(i)) heap.push({area[i], i});
+    }
+    
+    DisjointSets sets(num_islands);
+    std::vector<int> mark(num_islands, -1);
+    std::vector<double> shared(num_islands, 0.0);
+    std::vector<int> touched;
+    
+    while (!heap.empty()) {
+        const Entry top = heap.top();
+        heap.pop();
+        const int x = top.second;
+        if (sets.find(x) != x || top.first != area[x] || !isSmall(x)) continue;
+        
+        // 压缩邻接表：邻岛换成当前的根，同一根的共享长度相加，去掉自身
+        touched.clear();
+        for (const auto& entry : adjacency[x]) {
+            const int r = sets.find(entry.first);
+            if (r == x) continue;
+            if (mark[r] != x) {
+                mark[r] = x;
+                shared[r] = 0.0;
+                touched.push_back(r);
+            }
+            shared[r] += entry.second;
+        }
+        
+        // 共享缝合线最长的邻岛，长度相同时取 ID 较小者
+        adjacency[x].clear();
+        int best = -1;
+        for (int r : touched) {
+            adjacency[x].emplace_back(r, shared[r]);
+            if (best < 0 || shared[r] > shared[best] || (shared[r] == shared[best] && r < best)) {
+                best = r;
+            }
+        }
+        for (int r : touched) mark[r] = -1;
+        if (best < 0) continue;  // 没有邻岛（独立的连通分量）
+        
+        // 较短的邻接表接到较长的后面，总代价 O(E log I)
+        const int root = sets.unite(x, best);
+        const int child = root == x ? best : x;
+        if (adjacency[root].size() < adjacency[child].size()) {
+            std::swap(adjacency[root], adjacency[child]);
+        }
+        adjacency[root].insert(adjacency[root].end(), adjacency[child].begin(), adjacency[child].end());
+        adjacency[child] = {};
+        area[root] = area[x] + area[best];
+        face_count[root] = face_count[x] + face_count[best];
+        if (isSmall(root)) heap.push({area[root], root});
+    }
+    
+    // 新岛按成员中最小的原岛 ID 编号，保持“按最小面索引升序”
+    std::vector<int> new_id(num_islands, -1);
+    int num_merged = 0;
+    for (int i = 0; i < num_islands; ++i) {
+        const int r = sets.find(i);
+        if (new_id[r] < 0) new_id[r] = num_merged++;
+        new_id[i] = new_id[r];
+    }
+    
+    IslandSet merged;
+    merged.face_island.resize(islands.face_island.size());
+    igl::parallel_for(static_cast<int>(islands.face_island.size()), [&](int f) {
+        merged.face_island[f] = new_id[islands.face_island[f]];
+    }, 1 << 12);
+    
+    // 面 CSR：按原岛 ID 顺序把各原岛的面接到所属新岛之后
+    merged.face_offsets.assign(num_merged + 1, 0);
+    for (int i = 0; i < num_islands; ++i) {
+        merged.face_offsets[new_id[i] + 1] += islands.face_offsets[i + 1] - islands.face_offsets[i];
+    }
+    for (int i = 0; i < num_merged; ++i) {
+        merged.face_offsets[i + 1] += merged.face_offsets[i];
+    }
+    merged.faces.resize(islands.faces.size());
+    std::vector<int> cursor(merged.face_offsets.begin(), merged.face_offsets.end() - 1);
+    for (int i = 0; i < num_islands; ++i) {
+        const ConstSpan<int> faces = islands.islandFaces(i);
+        std::copy(faces.begin(), faces.end(), merged.faces.begin() + cursor[new_id[i]]);
+        cursor[new_id[i]] += static_cast<int>(faces.size());
+    }
+    
+    // 边界边：去掉已合并的原岛之间的边，其余（含岛内切缝）保留并作为切割边
+    auto keepEdge = [&](int i, int ei) {
+        for (HalfedgeIndex k = topo.edge_face_offsets[ei]; k < topo.edge_face_offsets[ei + 1]; ++k) {
+            const int j = islands.face_island[topo.edge_faces[k]];
+            if (j != i && new_id[j] == new_id[i]) return false;
+        }
+        return true;
+    };
+    
+    std::vector<std::vector<int>> members(num_merged);
+    for (int i = 0; i < num_islands; ++i) members[new_id[i]].push_back(i);
+    
+    EdgeMask cut_edges(topo.numEdges());
+    merged.boundary_offsets.push_back(0);
+    for (int n = 0; n < num_merged; ++n) {
+        for (int i : members[n]) {
+            for (const Edge& e : islands.islandBoundary(i)) {
+                const int ei = topo.findEdge(e.v0, e.v1);
+                if (ei >= 0 && !keepEdge(i, ei)) continue;
+                merged.boundary.push_back(e);
+                if (ei >= 0) cut_edges.set(ei);
+            }
+        }
+        merged.boundary_offsets.push_back(static_cast<HalfedgeIndex>(merged.boundary.size()));
+    }
+    
+    traceBoundaryLoops(topo, cut_edges, merged);
+    merged.cut_edges = std::move(cut_edges);
+    computeIslandStatistics(V, F, merged, options.geometry);
+    if (options.island_adjacency) buildIslandAdjacency(V, topo, merged, options.geometry);
+    
+    return merged;
+}
+
+template <typename DerivedV, typename DerivedF>
+std::vector<UVIsland> mergeSmallIslands(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const std::vector<UVIsland>& islands,
+    double min_area,
+    int min_faces
+) {
+    // 岛须恰好覆盖 [0, F.rows()) 中的每个面一次，否则面标签不完整，原样返回
+    const int num_faces = static_cast<int>(F.rows());
+    std::vector<int> face_island(num_faces, -1);
+    int covered = 0;
+    for (size_t i = 0; i < islands.size(); ++i) {
+        for (int f : islands[i].faces) {
+            if (f < 0 || f >= num_faces || face_island[f] >= 0) return islands;
+            face_island[f] = static_cast<int>(i);
+            ++covered;
+        }
+    }
+    if (covered != num_faces) return islands;
+    
+    const MeshTopology topo = buildMeshTopology(V, F);
+    
+    // 从 UVIsland 列表重建合并所需的面标签、CSR、面积和邻接图
+    IslandSet set;
+    set.face_island = std::move(face_island);
+    set.face_offsets.push_back(0);
+    set.boundary_offsets.push_back(0);
+    for (size_t i = 0; i < islands.size(); ++i) {
+        set.faces.insert(set.faces.end(), islands[i].faces.begin(), islands[i].faces.end());
+        set.boundary.insert(set.boundary.end(), islands[i].boundary.begin(), islands[i].boundary.end());
+        set.face_offsets.push_back(static_cast<int>(set.faces.size()));
+        set.boundary_offsets.push_back(static_cast<HalfedgeIndex>(set.boundary.size()));
+        set.areas.push_back(islands[i].area);
+    }
+    buildIslandAdjacency(V, topo, set);
+    
+    return toUVIslands(mergeSmallIslands(V, F, topo, set, min_area, min_faces));
+}
+
+#define UV_SEGMENTATION_INSTANTIATE(DerivedV, DerivedF) \
+    template IslandSet mergeSmallIslands<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const MeshTopology&, const IslandSet&, double, int, const SegmentationOptions&); \
+    template std::vector<UVIsland> mergeSmallIslands<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        const std::vector<UVIsland>&, double, int);
+UV_SEGMENTATION_MESH_TYPES(UV_SEGMENTATION_INSTANTIATE)
+#undef UV_SEGMENTATION_INSTANTIATE
+
+} // namespace UVSegmentation
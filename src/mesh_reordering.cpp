@@ -0,0 +1,166 @@
+#include "uv_segmentation.h"
+#include "segmentation_internal.h"
+#include <igl/parallel_for.h>
+
+namespace UVSegmentation {
+
+namespace {
+
+constexpr int kMortonBits = 21;  // 每个坐标轴 21 位，共 63 位
+
+/**
+ * @brief 将 21 位整数的各位间隔两位展开
+ */
+uint64_t spreadBits(uint64_t x) {
+    x &= 0x1fffff;
+    x = (x | x << 32) & 0x1f00000000ffffULL;
+    x = (x | x << 16) & 0x1f0000ff0000ffULL;
+    x = (x | x << 8) & 0x100f00f00f00f00fULL;
+    x = (x | x << 4) & 0x10c30c30c30c30c3ULL;
+    x = (x | x << 2) & 0x1249249249249249ULL;
+    return x;
+}
+
+} // namespace
+
+template <typename DerivedV, typename DerivedF>
+MeshReordering reorderMeshForLocality(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    PlainMatrix<DerivedV>& V_out,
+    PlainMatrix<DerivedF>& F_out
+) {
+    MeshReordering reordering;
+    if (!withinIndexLimits(V.rows(), F.rows())) {
+        V_out.resize(0, V.cols());
+        F_out.resize(0, F.cols());
+        return reordering;
+    }
+    
+    const int num_vertices = static_cast<int>(V.rows());
+    const int num_faces = static_cast<int>(F.rows());
+    
+    // 量化到包围盒内的 21 位网格
+    Eigen::RowVector3d min_pt = Eigen::RowVector3d::Zero();
+    Eigen::RowVector3d scale = Eigen::RowVector3d::Zero();
+    if (num_vertices > 0) {
+        min_pt = V.colwise().minCoeff().template cast<double>();
+        Eigen::RowVector3d extent = V.colwise().maxCoeff().template cast<double>() - min_pt;
+        const double cells = double((1 << kMortonBits) - 1);
+        for (int k = 0; k < 3; ++k) {
+            scale(k) = extent(k) > 0 ? cells / extent(k) : 0.0;
+        }
+    }
+    
+    // 面重心的 Morton 码
+    std::vector<uint64_t> keys(num_faces);
+    reordering.face_new_to_old.resize(num_faces);
+    igl::parallel_for(num_faces, [&](int fi) {
+        const Eigen::Vector3d c = (cornerPosition(V, F, fi, 0) + cornerPosition(V, F, fi, 1) +
+                                   cornerPosition(V, F, fi, 2)) / 3.0;
+        uint64_t code = 0;
+        for (int k = 0; k < 3; ++k) {
+            code |= spreadBits(static_cast<uint64_t>((c(k) - min_pt(k)) * scale(k))) << k;
+        }
+        keys[fi] = code;
+        reordering.face_new_to_old[fi] = fi;
+    }, 1 << 12);
+    
+    radixSortPairs(keys, reordering.face_new_to_old, 3 * kMortonBits);
+    
+    reordering.face_old_to_new.resize(num_faces);
+    igl::parallel_for(num_faces, [&](int f) {
+        reordering.face_old_to_new[reordering.face_new_to_old[f]] = f;
+    }, 1 << 12);
+    
+    // 顶点按首次被重排后的面引用的顺序编号
+    reordering.vertex_old_to_new.assign(num_vertices, -1);
+    reordering.vertex_new_to_old.clear();
+    reordering.vertex_new_to_old.reserve(num_vertices);
+    for (int f = 0; f < num_faces; ++f) {
+        const int old_face = reordering.face_new_to_old[f];
+        for (int j = 0; j < 3; ++j) {
+            const int v = static_cast<int>(F(old_face, j));
+            if (reordering.vertex_old_to_new[v] < 0) {
+                reordering.vertex_old_to_new[v] = static_cast<int>(reordering.vertex_new_to_old.size());
+                reordering.vertex_new_to_old.push_back(v);
+            }
+        }
+    }
+    for (int v = 0; v < num_vertices; ++v) {
+        if (reordering.vertex_old_to_new[v] < 0) {
+            reordering.vertex_old_to_new[v] = static_cast<int>(reordering.vertex_new_to_old.size());
+            reordering.vertex_new_to_old.push_back(v);
+        }
+    }
+    
+    V_out.resize(num_vertices, V.cols());
+    igl::parallel_for(num_vertices, [&](int v) {
+        V_out.row(v) = V.row(reordering.vertex_new_to_old[v]);
+    }, 1 << 12);
+    
+    F_out.resize(num_faces, 3);
+    igl::parallel_for(num_faces, [&](int f) {
+        const int old_face = reordering.face_new_to_old[f];
+        for (int j = 0; j < 3; ++j) {
+            F_out(f, j) = reordering.vertex_old_to_new[F(old_face, j)];
+        }
+    }, 1 << 12);
+    
+    return reordering;
+}
+
+void restoreOriginalIndices(
+    const MeshReordering& reordering,
+    std::vector<UVIsland>& islands
+) {
+    for (UVIsland& island : islands) {
+        for (int& fi : island.faces) {
+            fi = reordering.face_new_to_old[fi];
+        }
+        for (Edge& e : island.boundary) {
+            e = Edge(reordering.vertex_new_to_old[e.v0], reordering.vertex_new_to_old[e.v1]);
+        }
+        for (std::vector<int>& loop : island.boundary_loops) {
+            for (int& v : loop) {
+                v = reordering.vertex_new_to_old[v];
+            }
+        }
+    }
+}
+
+void restoreOriginalIndices(
+    const MeshReordering& reordering,
+    IslandSet& islands
+) {
+    igl::parallel_for(static_cast<int>(islands.faces.size()), [&](int k) {
+        islands.faces[k] = reordering.face_new_to_old[islands.faces[k]];
+    }, 1 << 12);
+    
+    std::vector<int> face_island(islands.face_island.size());
+    igl::parallel_for(static_cast<int>(face_island.size()), [&](int f) {
+        face_island[reordering.face_new_to_old[f]] = islands.face_island[f];
+    }, 1 << 12);
+    islands.face_island = std::move(face_island);
+    
+    igl::parallel_for(static_cast<int>(islands.boundary.size()), [&](int k) {
+        const Edge& e = islands.boundary[k];
+        islands.boundary[k] = Edge(reordering.vertex_new_to_old[e.v0], reordering.vertex_new_to_old[e.v1]);
+    }, 1 << 12);
+    
+    igl::parallel_for(static_cast<int>(islands.loop_vertices.size()), [&](int k) {
+        islands.loop_vertices[k] = reordering.vertex_new_to_old[islands.loop_vertices[k]];
+    }, 1 << 12);
+    
+    // 切割位按重排后拓扑的边 ID，原网格的边编号不同，无法沿用
+    islands.cut_edges = EdgeMask();
+}
+
+#define UV_SEGMENTATION_INSTANTIATE(DerivedV, DerivedF) \
+    template MeshReordering reorderMeshForLocality<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        PlainMatrix<DerivedV>&, PlainMatrix<DerivedF>&);
+UV_SEGMENTATION_MESH_TYPES(UV_SEGMENTATION_INSTANTIATE)
+#undef UV_SEGMENTATION_INSTANTIATE
+
+} // namespace UVSegmentation
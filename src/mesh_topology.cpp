@@ -0,0 +1,240 @@
+#include "uv_segmentation.h"
+#include "segmentation_internal.h"
+#include <igl/parallel_for.h>
+#include <igl/default_num_threads.h>
+#include <cstdint>
+
+namespace UVSegmentation {
+
+namespace {
+
+constexpr int kRadixBits = 8;
+constexpr int kRadixBuckets = 1 << kRadixBits;
+
+} // namespace
+
+Chunks::Chunks(size_t n) {
+    const size_t threads = std::max<size_t>(1, igl::default_num_threads());
+    count = std::max<size_t>(1, std::min(threads, n / kMinChunkSize));
+    size = (n + count - 1) / count;
+}
+
+template <typename Value>
+void radixSortPairs(std::vector<uint64_t>& keys, std::vector<Value>& values, int key_bits) {
+    const size_t n = keys.size();
+    if (n < 2) return;
+    
+    const Chunks chunks(n);
+    std::vector<uint64_t> keys_tmp(n);
+    std::vector<Value> values_tmp(n);
+    std::vector<size_t> hist(chunks.count * kRadixBuckets);
+    
+    for (int shift = 0; shift < key_bits; shift += kRadixBits) {
+        std::fill(hist.begin(), hist.end(), 0);
+        
+        igl::parallel_for(chunks.count, [&](size_t c) {
+            size_t* h = &hist[c * kRadixBuckets];
+            for (size_t i = chunks.begin(c, n); i < chunks.end(c, n); ++i) {
+                ++h[(keys[i] >> shift) & (kRadixBuckets - 1)];
+            }
+        }, 2);
+        
+        // 所有键落在同一个桶时跳过本轮
+        bool trivial = false;
+        for (int b = 0; b < kRadixBuckets && !trivial; ++b) {
+            size_t total = 0;
+            for (size_t c = 0; c < chunks.count; ++c) total += hist[c * kRadixBuckets + b];
+            trivial = (total == n);
+        }
+        if (trivial) continue;
+        
+        size_t sum = 0;
+        for (int b = 0; b < kRadixBuckets; ++b) {
+            for (size_t c = 0; c < chunks.count; ++c) {
+                size_t count = hist[c * kRadixBuckets + b];
+                hist[c * kRadixBuckets + b] = sum;
+                sum += count;
+            }
+        }
+        
+        igl::parallel_for(chunks.count, [&](size_t c) {
+            size_t* h = &hist[c * kRadixBuckets];
+            for (size_t i = chunks.begin(c, n); i < chunks.end(c, n); ++i) {
+                size_t dst = h[(keys[i] >> shift) & (kRadixBuckets - 1)]++;
+                keys_tmp[dst] = keys[i];
+                values_tmp[dst] = values[i];
+            }
+        }, 2);
+        
+        keys.swap(keys_tmp);
+        values.swap(values_tmp);
+    }
+}
+
+template void radixSortPairs<int>(std::vector<uint64_t>&, std::vector<int>&, int);
+template void radixSortPairs<int64_t>(std::vector<uint64_t>&, std::vector<int64_t>&, int);
+
+namespace {
+
+/**
+ * @brief 表示 [0, n) 内整数所需的位数
+ */
+int bitWidth(uint64_t n) {
+    int bits = 0;
+    while (bits < 64 && (n >> bits) != 0) ++bits;
+    return std::max(bits, 1);
+}
+
+} // namespace
+
+int MeshTopology::findEdge(int a, int b) const {
+    if (a < 0 || b < 0 || a >= num_vertices || b >= num_vertices) return -1;
+    
+    const int lo = std::min(a, b);
+    const int hi = std::max(a, b);
+    for (HalfedgeIndex k = vertex_edge_offsets[lo]; k < vertex_edge_offsets[lo + 1]; ++k) {
+        const Edge& e = edges[vertex_edges[k]];
+        if (e.v0 == lo && e.v1 == hi) return vertex_edges[k];
+    }
+    return -1;
+}
+
+template <typename DerivedV, typename DerivedF>
+MeshTopology buildMeshTopology(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F
+) {
+    if (!withinIndexLimits(V.rows(), F.rows())) return MeshTopology();
+    return buildTopology(static_cast<int>(V.rows()), F);
+}
+
+template <typename DerivedF>
+MeshTopology buildTopology(int num_vertices, const Eigen::MatrixBase<DerivedF>& F) {
+    MeshTopology topo;
+    if (!withinIndexLimits(num_vertices, F.rows())) return topo;
+    topo.num_vertices = num_vertices;
+    topo.num_faces = static_cast<int>(F.rows());
+    
+    const size_t num_halfedges = static_cast<size_t>(F.rows()) * 3;
+    const int vertex_bits = bitWidth(topo.num_vertices);
+    
+    // 每条半边生成 64 位键 (较小顶点, 较大顶点)，值为半边索引 3 * f + i
+    std::vector<uint64_t> keys(num_halfedges);
+    std::vector<HalfedgeIndex> halfedges(num_halfedges);
+    igl::parallel_for(topo.num_faces, [&](int fi) {
+        for (int i = 0; i < 3; ++i) {
+            uint64_t v0 = static_cast<uint32_t>(F(fi, i));
+            uint64_t v1 = static_cast<uint32_t>(F(fi, (i + 1) % 3));
+            if (v0 > v1) std::swap(v0, v1);
+            const HalfedgeIndex h = MeshTopology::corner(fi, i);
+            keys[h] = (v0 << vertex_bits) | v1;
+            halfedges[h] = h;
+        }
+    }, 1 << 12);
+    
+    radixSortPairs(keys, halfedges, 2 * vertex_bits);
+    
+    // 排序后相同键连续：每段的起点即一条唯一边，段内按面索引升序。
+    // 先按块统计段起点数，再求前缀和得到每块的起始边 ID。
+    const Chunks chunks(num_halfedges);
+    std::vector<int64_t> chunk_edge_start(chunks.count + 1, 0);
+    igl::parallel_for(chunks.count, [&](size_t c) {
+        int64_t heads = 0;
+        for (size_t i = chunks.begin(c, num_halfedges); i < chunks.end(c, num_halfedges); ++i) {
+            if (i == 0 || keys[i] != keys[i - 1]) ++heads;
+        }
+        chunk_edge_start[c + 1] = heads;
+    }, 2);
+    for (size_t c = 0; c < chunks.count; ++c) {
+        chunk_edge_start[c + 1] += chunk_edge_start[c];
+    }
+    
+    // 边 ID 为 int：非流形网格的边数最多为半边数，可能超出
+    if (chunk_edge_start[chunks.count] > std::numeric_limits<int>::max()) return MeshTopology();
+    const int num_edges = static_cast<int>(chunk_edge_start[chunks.count]);
+    const uint64_t low_mask = (uint64_t(1) << vertex_bits) - 1;
+    
+    topo.edges.assign(num_edges, Edge(0, 0));
+    topo.edge_face_offsets.resize(num_edges + 1);
+    topo.edge_faces.resize(num_halfedges);
+    topo.face_edges.resize(num_halfedges);
+    topo.edge_face_offsets[num_edges] = static_cast<HalfedgeIndex>(num_halfedges);
+    
+    igl::parallel_for(chunks.count, [&](size_t c) {
+        int ei = static_cast<int>(chunk_edge_start[c]) - 1;
+        for (size_t i = chunks.begin(c, num_halfedges); i < chunks.end(c, num_halfedges); ++i) {
+            if (i == 0 || keys[i] != keys[i - 1]) {
+                ++ei;
+                topo.edges[ei] = Edge(static_cast<int>(keys[i] >> vertex_bits),
+                                      static_cast<int>(keys[i] & low_mask));
+                topo.edge_face_offsets[ei] = static_cast<HalfedgeIndex>(i);
+            }
+            topo.edge_faces[i] = static_cast<int>(halfedges[i] / 3);
+            topo.face_edges[halfedges[i]] = ei;
+        }
+    }, 2);
+    
+    // 面邻接表（对偶图）：BFS 时直接按 3 * f + i 取相邻面
+    topo.face_neighbors.resize(num_halfedges);
+    igl::parallel_for(topo.num_faces, [&](int fi) {
+        for (int i = 0; i < 3; ++i) {
+            const int ei = topo.faceEdge(fi, i);
+            const HalfedgeIndex begin = topo.edge_face_offsets[ei];
+            int neighbor = MeshTopology::kNoNeighbor;
+            switch (topo.edgeFaceCount(ei)) {
+                case 1:
+                    break;
+                case 2:
+                    neighbor = topo.edge_faces[begin] == fi ? topo.edge_faces[begin + 1]
+                                                            : topo.edge_faces[begin];
+                    break;
+                default:
+                    neighbor = MeshTopology::kNonManifold;
+                    break;
+            }
+            topo.face_neighbors[MeshTopology::corner(fi, i)] = neighbor;
+        }
+    }, 1 << 12);
+    
+    // 顶点 -> 边：每条边生成两个 (顶点, 边) 对，按顶点排序即得 CSR
+    std::vector<uint64_t> vertex_keys(2 * static_cast<size_t>(num_edges));
+    std::vector<int> vertex_edges(2 * static_cast<size_t>(num_edges));
+    igl::parallel_for(num_edges, [&](int e) {
+        const size_t k = 2 * static_cast<size_t>(e);
+        vertex_keys[k] = static_cast<uint64_t>(topo.edges[e].v0);
+        vertex_keys[k + 1] = static_cast<uint64_t>(topo.edges[e].v1);
+        vertex_edges[k] = e;
+        vertex_edges[k + 1] = e;
+    }, 1 << 12);
+    
+    radixSortPairs(vertex_keys, vertex_edges, vertex_bits);
+    
+    // offsets[v] = 键小于 v 的个数：位置 i 负责区间 (keys[i-1], keys[i]] 内的顶点
+    const size_t num_pairs = vertex_keys.size();
+    topo.vertex_edge_offsets.resize(topo.num_vertices + 1);
+    igl::parallel_for(num_pairs + 1, [&](size_t i) {
+        uint64_t first = (i == 0) ? 0 : vertex_keys[i - 1] + 1;
+        uint64_t last = (i == num_pairs) ? topo.num_vertices : vertex_keys[i];
+        for (uint64_t v = first; v <= last; ++v) {
+            topo.vertex_edge_offsets[v] = static_cast<HalfedgeIndex>(i);
+        }
+    }, 1 << 12);
+    topo.vertex_edges.swap(vertex_edges);
+    
+    buildHalfEdges(F, topo);
+    
+    return topo;
+}
+
+#define UV_SEGMENTATION_INSTANTIATE(DerivedF) \
+    template MeshTopology buildTopology<DerivedF>(int, const Eigen::MatrixBase<DerivedF>&);
+UV_SEGMENTATION_FACE_TYPES(UV_SEGMENTATION_INSTANTIATE)
+#undef UV_SEGMENTATION_INSTANTIATE
+
+#define UV_SEGMENTATION_INSTANTIATE(DerivedV, DerivedF) \
+    template MeshTopology buildMeshTopology<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&);
+UV_SEGMENTATION_MESH_TYPES(UV_SEGMENTATION_INSTANTIATE)
+#undef UV_SEGMENTATION_INSTANTIATE
+
+} // namespace UVSegmentation
@@ -0,0 +1,359 @@
+#include "uv_segmentation.h"
+#include "segmentation_internal.h"
+#include <igl/parallel_for.h>
+#include <numeric>
+
+namespace UVSegmentation {
+
+namespace {
+
+enum FaceStatus : uint8_t {
+    kFaceOk = 0,
+    kFaceOutOfRange,
+    kFaceDegenerate,
+    kFaceDuplicate
+};
+
+uint64_t hashTriangle(int a, int b, int c) {
+    if (a > b) std::swap(a, b);
+    if (b > c) std::swap(b, c);
+    if (a > b) std::swap(a, b);
+    uint64_t h = static_cast<uint32_t>(a);
+    h = h * 0x9E3779B97F4A7C15ull + static_cast<uint32_t>(b);
+    h = h * 0x9E3779B97F4A7C15ull + static_cast<uint32_t>(c);
+    h ^= h >> 31;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 29;
+    return h;
+}
+
+template <typename DerivedF>
+bool sameTriangle(const Eigen::MatrixBase<DerivedF>& F, int f, int g) {
+    typename DerivedF::Scalar a[3] = {F(f, 0), F(f, 1), F(f, 2)};
+    typename DerivedF::Scalar b[3] = {F(g, 0), F(g, 1), F(g, 2)};
+    std::sort(a, a + 3);
+    std::sort(b, b + 3);
+    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+}
+
+/**
+ * @brief 逐面分类：越界 -> 退化 -> 重复（只在前两项都通过的面之间比较）
+ */
+template <typename DerivedV, typename DerivedF>
+std::vector<uint8_t> classifyFaces(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    double area_epsilon
+) {
+    const int num_faces = static_cast<int>(F.rows());
+    const int num_vertices = static_cast<int>(V.rows());
+    std::vector<uint8_t> status(num_faces, kFaceOk);
+    
+    igl::parallel_for(num_faces, [&](int f) {
+        for (int i = 0; i < 3; ++i) {
+            const int64_t v = static_cast<int64_t>(F(f, i));
+            if (v < 0 || v >= num_vertices) {
+                status[f] = kFaceOutOfRange;
+                return;
+            }
+        }
+        const Eigen::Vector3d p0 = cornerPosition(V, F, f, 0);
+        const Eigen::Vector3d e1 = cornerPosition(V, F, f, 1) - p0;
+        const Eigen::Vector3d e2 = cornerPosition(V, F, f, 2) - p0;
+        if (F(f, 0) == F(f, 1) || F(f, 1) == F(f, 2) || F(f, 2) == F(f, 0) ||
+            0.5 * e1.cross(e2).norm() <= area_epsilon) {
+            status[f] = kFaceDegenerate;
+        }
+    }, 1 << 12);
+    
+    // 按排序后顶点三元组的哈希分桶（位数略多于面数，冲突很少），
+    // 同桶内与更早的面逐个比较；稳定排序保证桶内按面索引升序
+    int key_bits = 8;
+    while (key_bits < 64 && (int64_t(1) << (key_bits - 8)) < num_faces) ++key_bits;
+    const uint64_t key_mask = (key_bits == 64) ? ~uint64_t(0) : (uint64_t(1) << key_bits) - 1;
+    
+    std::vector<uint64_t> keys(num_faces);
+    std::vector<int> order(num_faces);
+    igl::parallel_for(num_faces, [&](int f) {
+        keys[f] = (status[f] == kFaceOutOfRange) ? 0 :
+            hashTriangle(static_cast<int>(F(f, 0)), static_cast<int>(F(f, 1)), static_cast<int>(F(f, 2))) & key_mask;
+        order[f] = f;
+    }, 1 << 12);
+    radixSortPairs(keys, order, key_bits);
+    
+    // 每块处理起点落在块内的桶，桶可以越过块尾
+    const size_t n = keys.size();
+    const Chunks chunks(n);
+    igl::parallel_for(chunks.count, [&](size_t c) {
+        size_t run = chunks.begin(c, n);
+        while (run > 0 && run < n && keys[run] == keys[run - 1]) ++run;
+        
+        while (run < chunks.end(c, n)) {
+            size_t run_end = run + 1;
+            while (run_end < n && keys[run_end] == keys[run]) ++run_end;
+            
+            for (size_t q = run + 1; q < run_end; ++q) {
+                if (status[order[q]] != kFaceOk) continue;
+                for (size_t p = run; p < q; ++p) {
+                    if (status[order[p]] == kFaceOk && sameTriangle(F, order[p], order[q])) {
+                        status[order[q]] = kFaceDuplicate;
+                        break;
+                    }
+                }
+            }
+            run = run_end;
+        }
+    }, 2);
+    
+    return status;
+}
+
+template <typename DerivedF>
+PlainMatrix<DerivedF> gatherFaces(const Eigen::MatrixBase<DerivedF>& F, const std::vector<int>& faces) {
+    PlainMatrix<DerivedF> out(faces.size(), 3);
+    igl::parallel_for(static_cast<int>(faces.size()), [&](int i) {
+        out.row(i) = F.row(faces[i]);
+    }, 1 << 12);
+    return out;
+}
+
+/**
+ * @brief 顶点一环的扇区划分（每个线程复用一份缓冲区）
+ * 
+ * 扇区是经由该顶点处的流形边（恰好两个面）相连的面组。
+ * 计算后 faces 为升序的关联面，fan[k] 为 faces[k] 的扇区编号，
+ * 扇区按其最小面索引编号。
+ */
+struct VertexFans {
+    std::vector<int> faces;
+    std::vector<int> fan;
+    std::vector<int> parent;
+    
+    int compute(const MeshTopology& topo, int v) {
+        faces.clear();
+        for (HalfedgeIndex k = topo.vertex_edge_offsets[v]; k < topo.vertex_edge_offsets[v + 1]; ++k) {
+            const int e = topo.vertex_edges[k];
+            for (HalfedgeIndex j = topo.edge_face_offsets[e]; j < topo.edge_face_offsets[e + 1]; ++j) {
+                faces.push_back(topo.edge_faces[j]);
+            }
+        }
+        std::sort(faces.begin(), faces.end());
+        faces.erase(std::unique(faces.begin(), faces.end()), faces.end());
+        
+        parent.resize(faces.size());
+        std::iota(parent.begin(), parent.end(), 0);
+        auto local = [&](int f) {
+            return static_cast<int>(std::lower_bound(faces.begin(), faces.end(), f) - faces.begin());
+        };
+        auto root = [&](int x) {
+            while (parent[x] != x) x = parent[x] = parent[parent[x]];
+            return x;
+        };
+        
+        for (HalfedgeIndex k = topo.vertex_edge_offsets[v]; k < topo.vertex_edge_offsets[v + 1]; ++k) {
+            const int e = topo.vertex_edges[k];
+            if (topo.edgeFaceCount(e) != 2) continue;
+            int a = root(local(topo.edge_faces[topo.edge_face_offsets[e]]));
+            int b = root(local(topo.edge_faces[topo.edge_face_offsets[e] + 1]));
+            if (a == b) continue;
+            if (a < b) std::swap(a, b);
+            parent[a] = b;
+        }
+        
+        // 根总是组内最小下标，按下标升序首次出现的根依次编号
+        int count = 0;
+        fan.resize(faces.size());
+        for (size_t k = 0; k < faces.size(); ++k) {
+            const int r = root(static_cast<int>(k));
+            fan[k] = (r == static_cast<int>(k)) ? count++ : fan[r];
+        }
+        return count;
+    }
+};
+
+/**
+ * @brief 每个顶点的扇区数（孤立顶点为 0）
+ */
+std::vector<int> countVertexFans(const MeshTopology& topo) {
+    std::vector<int> fans(topo.num_vertices);
+    const Chunks chunks(topo.num_vertices);
+    igl::parallel_for(chunks.count, [&](size_t c) {
+        VertexFans scratch;
+        for (size_t v = chunks.begin(c, topo.num_vertices); v < chunks.end(c, topo.num_vertices); ++v) {
+            fans[v] = scratch.compute(topo, static_cast<int>(v));
+        }
+    }, 2);
+    return fans;
+}
+
+/**
+ * @brief 完整检查，同时返回逐面状态、通过检查的面及其拓扑供修复复用
+ */
+template <typename DerivedV, typename DerivedF>
+MeshValidationReport validate(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    double area_epsilon,
+    std::vector<uint8_t>& status,
+    std::vector<int>& clean_faces,
+    MeshTopology& clean_topo
+) {
+    MeshValidationReport report;
+    status = classifyFaces(V, F, area_epsilon);
+    
+    clean_faces.clear();
+    for (int f = 0; f < F.rows(); ++f) {
+        switch (status[f]) {
+            case kFaceOk: clean_faces.push_back(f); break;
+            case kFaceOutOfRange: ++report.out_of_range_faces; break;
+            case kFaceDegenerate: ++report.degenerate_faces; break;
+            case kFaceDuplicate: ++report.duplicate_faces; break;
+        }
+    }
+    
+    clean_topo = buildTopology(static_cast<int>(V.rows()), gatherFaces(F, clean_faces));
+    for (int e = 0; e < clean_topo.numEdges(); ++e) {
+        if (clean_topo.edgeFaceCount(e) > 2) ++report.non_manifold_edges;
+    }
+    for (int fans : countVertexFans(clean_topo)) {
+        if (fans > 1) ++report.non_manifold_vertices;
+    }
+    
+    return report;
+}
+
+} // namespace
+
+template <typename DerivedV, typename DerivedF>
+MeshValidationReport validateMesh(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    double area_epsilon
+) {
+    MeshValidationReport report;
+    report.exceeds_index_limits = !withinIndexLimits(V.rows(), F.rows());
+    if (report.exceeds_index_limits) return report;
+    
+    std::vector<uint8_t> status;
+    std::vector<int> clean_faces;
+    MeshTopology clean_topo;
+    return validate(V, F, area_epsilon, status, clean_faces, clean_topo);
+}
+
+template <typename DerivedV, typename DerivedF>
+MeshRepairResult repairMesh(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    PlainMatrix<DerivedV>& V_out,
+    PlainMatrix<DerivedF>& F_out,
+    const MeshRepairOptions& options
+) {
+    MeshRepairResult result;
+    result.report.exceeds_index_limits = !withinIndexLimits(V.rows(), F.rows());
+    if (result.report.exceeds_index_limits) {
+        V_out.resize(0, V.cols());
+        F_out.resize(0, F.cols());
+        return result;
+    }
+    
+    std::vector<uint8_t> status;
+    std::vector<int> kept;
+    MeshTopology topo;
+    result.report = validate(V, F, options.area_epsilon, status, kept, topo);
+    
+    // 保留部分退化/重复面时重新收集并构建拓扑
+    if ((!options.drop_degenerate_faces && result.report.degenerate_faces > 0) ||
+        (!options.drop_duplicate_faces && result.report.duplicate_faces > 0)) {
+        kept.clear();
+        for (int f = 0; f < F.rows(); ++f) {
+            if (status[f] == kFaceOk ||
+                (status[f] == kFaceDegenerate && !options.drop_degenerate_faces) ||
+                (status[f] == kFaceDuplicate && !options.drop_duplicate_faces)) {
+                kept.push_back(f);
+            }
+        }
+        topo = buildTopology(static_cast<int>(V.rows()), gatherFaces(F, kept));
+    }
+    
+    // 非流形边上只保留索引最小的两个面（edge_faces 段内按面索引升序）
+    if (options.drop_non_manifold_faces) {
+        std::vector<char> drop(kept.size(), 0);
+        bool any = false;
+        for (int e = 0; e < topo.numEdges(); ++e) {
+            for (HalfedgeIndex k = topo.edge_face_offsets[e] + 2; k < topo.edge_face_offsets[e + 1]; ++k) {
+                drop[topo.edge_faces[k]] = 1;
+                any = true;
+            }
+        }
+        if (any) {
+            std::vector<int> remaining;
+            for (size_t i = 0; i < kept.size(); ++i) {
+                if (!drop[i]) remaining.push_back(kept[i]);
+            }
+            kept.swap(remaining);
+            topo = buildTopology(static_cast<int>(V.rows()), gatherFaces(F, kept));
+        }
+    }
+    
+    result.face_new_to_old = kept;
+    F_out = gatherFaces(F, kept);
+    
+    result.vertex_new_to_old.resize(V.rows());
+    std::iota(result.vertex_new_to_old.begin(), result.vertex_new_to_old.end(), 0);
+    
+    if (options.split_non_manifold_vertices) {
+        // 第一个扇区保留原顶点，其余扇区的副本按 (顶点, 扇区) 顺序追加
+        const std::vector<int> fans = countVertexFans(topo);
+        std::vector<int> copy_offsets(fans.size() + 1, static_cast<int>(V.rows()));
+        for (size_t v = 0; v < fans.size(); ++v) {
+            copy_offsets[v + 1] = copy_offsets[v] + std::max(fans[v] - 1, 0);
+        }
+        
+        const int num_out = copy_offsets.back();
+        result.vertex_new_to_old.resize(num_out);
+        for (size_t v = 0; v < fans.size(); ++v) {
+            for (int k = copy_offsets[v]; k < copy_offsets[v + 1]; ++k) {
+                result.vertex_new_to_old[k] = static_cast<int>(v);
+            }
+        }
+        
+        // 角的归属从拓扑的半边起点读取（只读），各顶点只写自己的角，不读 F_out
+        const std::vector<int>& corner_vertex = topo.halfedges.vertex;
+        const Chunks chunks(fans.size());
+        igl::parallel_for(chunks.count, [&](size_t c) {
+            VertexFans scratch;
+            for (size_t v = chunks.begin(c, fans.size()); v < chunks.end(c, fans.size()); ++v) {
+                if (fans[v] < 2) continue;
+                scratch.compute(topo, static_cast<int>(v));
+                for (size_t k = 0; k < scratch.faces.size(); ++k) {
+                    if (scratch.fan[k] == 0) continue;
+                    const int f = scratch.faces[k];
+                    const int copy = copy_offsets[v] + scratch.fan[k] - 1;
+                    for (int j = 0; j < 3; ++j) {
+                        if (corner_vertex[MeshTopology::corner(f, j)] == static_cast<int>(v)) {
+                            F_out(f, j) = copy;
+                        }
+                    }
+                }
+            }
+        }, 2);
+    }
+    
+    V_out.resize(result.vertex_new_to_old.size(), V.cols());
+    igl::parallel_for(static_cast<int>(result.vertex_new_to_old.size()), [&](int v) {
+        V_out.row(v) = V.row(result.vertex_new_to_old[v]);
+    }, 1 << 12);
+    
+    return result;
+}
+
+#define UV_SEGMENTATION_INSTANTIATE(DerivedV, DerivedF) \
+    template MeshValidationReport validateMesh<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, double); \
+    template MeshRepairResult repairMesh<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, \
+        PlainMatrix<DerivedV>&, PlainMatrix<DerivedF>&, const MeshRepairOptions&);
+UV_SEGMENTATION_MESH_TYPES(UV_SEGMENTATION_INSTANTIATE)
+#undef UV_SEGMENTATION_INSTANTIATE
+
+} // namespace UVSegmentation
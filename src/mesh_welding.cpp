@@ -0,0 +1,197 @@
+#include "uv_segmentation.h"
+#include "segmentation_internal.h"
+#include <igl/parallel_for.h>
+#include <cmath>
+
+namespace UVSegmentation {
+
+namespace {
+
+constexpr int kCellBits = 21;
+constexpr uint64_t kCellMask = (uint64_t(1) << kCellBits) - 1;
+
+uint64_t cellKey(uint64_t x, uint64_t y, uint64_t z) {
+    return (x << (2 * kCellBits)) | (y << kCellBits) | z;
+}
+
+int findRoot(std::vector<int>& parent, int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+} // namespace
+
+template <typename DerivedV, typename DerivedF>
+WeldResult weldVertices(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    double tolerance,
+    PlainMatrix<DerivedV>& V_out,
+    PlainMatrix<DerivedF>& F_out
+) {
+    WeldResult result;
+    if (!withinIndexLimits(V.rows(), F.rows())) {
+        V_out.resize(0, V.cols());
+        F_out.resize(0, F.cols());
+        return result;
+    }
+    
+    const int num_vertices = static_cast<int>(V.rows());
+    tolerance = std::max(tolerance, 0.0);
+    const double tolerance_sq = tolerance * tolerance;
+    
+    // 网格单元：边长不小于容差，相距在容差内的点必落在相邻单元；
+    // 每轴单元数不超过 21 位（首尾各留一格，邻居坐标不会越界）
+    Eigen::RowVector3d min_pt = Eigen::RowVector3d::Zero();
+    double cell = 1.0;
+    if (num_vertices > 0) {
+        min_pt = V.colwise().minCoeff().template cast<double>();
+        const double max_extent = (V.colwise().maxCoeff().template cast<double>() - min_pt).maxCoeff();
+        cell = std::max(tolerance, max_extent / double(kCellMask - 2));
+        if (cell <= 0) cell = 1.0;
+    }
+    
+    // 每轴只用实际需要的位数，减少基数排序轮数
+    uint64_t max_cell = 0;
+    for (int k = 0; k < 3 && num_vertices > 0; ++k) {
+        const double extent = double(V.col(k).maxCoeff()) - min_pt(k);
+        max_cell = std::max(max_cell, static_cast<uint64_t>(extent / cell) + 2);
+    }
+    int axis_bits = 1;
+    while ((uint64_t(1) << axis_bits) <= max_cell) ++axis_bits;
+    
+    // 按单元键 (x, y, z 字典序) 排序顶点
+    std::vector<uint64_t> keys(num_vertices);
+    std::vector<int> order(num_vertices);
+    igl::parallel_for(num_vertices, [&](int i) {
+        uint64_t c[3];
+        for (int k = 0; k < 3; ++k) {
+            c[k] = std::min<uint64_t>(kCellMask - 1,
+                static_cast<uint64_t>((V(i, k) - min_pt(k)) / cell) + 1);
+        }
+        keys[i] = (c[0] << (2 * axis_bits)) | (c[1] << axis_bits) | c[2];
+        order[i] = i;
+    }, 1 << 12);
+    radixSortPairs(keys, order, 3 * axis_bits);
+    
+    // 统一成 21 位布局，并按排序顺序收集坐标，使候选点在内存中连续
+    const uint64_t axis_mask = (uint64_t(1) << axis_bits) - 1;
+    std::vector<Eigen::Vector3d> points(num_vertices);
+    igl::parallel_for(num_vertices, [&](int p) {
+        const uint64_t k = keys[p];
+        keys[p] = cellKey(k >> (2 * axis_bits), (k >> axis_bits) & axis_mask, k & axis_mask);
+        points[p] = V.row(order[p]).template cast<double>().transpose();
+    }, 1 << 12);
+    
+    // 每个点对只由字典序较大的单元一侧发现：扫描 13 个字典序较小的相邻单元
+    // 和本单元内排在自己之前的点。(dx, dy) 固定时 z 方向的单元在排序后连续，
+    // 共 5 个行区间；区间端点随 p 单调递增，用游标推进，整体线性。
+    const Chunks chunks(num_vertices);
+    std::vector<std::vector<std::pair<int, int>>> chunk_pairs(chunks.count);
+    igl::parallel_for(chunks.count, [&](size_t c) {
+        const size_t begin = chunks.begin(c, num_vertices);
+        const size_t end = chunks.end(c, num_vertices);
+        if (begin == end) return;
+        
+        auto& pairs = chunk_pairs[c];
+        size_t lo_cursor[5], hi_cursor[5];
+        bool initialized = false;
+        
+        for (size_t p = begin; p < end; ++p) {
+            const uint64_t key = keys[p];
+            const uint64_t x = key >> (2 * kCellBits);
+            const uint64_t y = (key >> kCellBits) & kCellMask;
+            const uint64_t z = key & kCellMask;
+            
+            for (int r = 0; r < 5; ++r) {
+                // 行 (-1,-1) (-1,0) (-1,1) (0,-1) 取 z-1..z+1，行 (0,0) 取 z-1..z
+                const uint64_t rx = (r < 3) ? x - 1 : x;
+                const uint64_t ry = (r < 3) ? y + r - 1 : y + r - 4;
+                const uint64_t lo = cellKey(rx, ry, z - 1);
+                const uint64_t hi = (r == 4) ? key : cellKey(rx, ry, z + 1);
+                if (!initialized) {
+                    lo_cursor[r] = std::lower_bound(keys.begin(), keys.end(), lo) - keys.begin();
+                    hi_cursor[r] = std::upper_bound(keys.begin(), keys.end(), hi) - keys.begin();
+                } else {
+                    while (keys[lo_cursor[r]] < lo) ++lo_cursor[r];
+                    while (hi_cursor[r] < keys.size() && keys[hi_cursor[r]] <= hi) ++hi_cursor[r];
+                }
+                
+                // 本单元只看排在自己之前的点
+                const size_t last = (r == 4) ? p : hi_cursor[r];
+                for (size_t q = lo_cursor[r]; q < last; ++q) {
+                    if ((points[q] - points[p]).squaredNorm() <= tolerance_sq) {
+                        pairs.push_back({order[p], order[q]});
+                    }
+                }
+            }
+            initialized = true;
+        }
+    }, 2);
+    
+    // 并查集求传递闭包，根始终为组内最小索引
+    std::vector<int> parent(num_vertices);
+    for (int i = 0; i < num_vertices; ++i) parent[i] = i;
+    for (const auto& pairs : chunk_pairs) {
+        for (const auto& [i, j] : pairs) {
+            int a = findRoot(parent, i);
+            int b = findRoot(parent, j);
+            if (a == b) continue;
+            if (a < b) std::swap(a, b);
+            parent[a] = b;
+        }
+    }
+    
+    // 按代表顶点索引升序重新编号
+    result.vertex_remap.resize(num_vertices);
+    std::vector<int> representatives;
+    for (int i = 0; i < num_vertices; ++i) {
+        const int root = findRoot(parent, i);
+        if (root == i) {
+            result.vertex_remap[i] = static_cast<int>(representatives.size());
+            representatives.push_back(i);
+        } else {
+            result.vertex_remap[i] = result.vertex_remap[root];
+        }
+    }
+    result.num_merged = num_vertices - static_cast<int>(representatives.size());
+    
+    V_out.resize(representatives.size(), V.cols());
+    igl::parallel_for(static_cast<int>(representatives.size()), [&](int v) {
+        V_out.row(v) = V.row(representatives[v]);
+    }, 1 << 12);
+    
+    // 重映射面，移除焊接后退化的面
+    result.face_new_to_old.reserve(F.rows());
+    for (int fi = 0; fi < F.rows(); ++fi) {
+        const int a = result.vertex_remap[static_cast<int>(F(fi, 0))];
+        const int b = result.vertex_remap[static_cast<int>(F(fi, 1))];
+        const int c = result.vertex_remap[static_cast<int>(F(fi, 2))];
+        if (a == b || b == c || c == a) {
+            ++result.num_degenerate_faces;
+        } else {
+            result.face_new_to_old.push_back(fi);
+        }
+    }
+    
+    F_out.resize(result.face_new_to_old.size(), 3);
+    igl::parallel_for(static_cast<int>(result.face_new_to_old.size()), [&](int f) {
+        for (int j = 0; j < 3; ++j) {
+            F_out(f, j) = result.vertex_remap[static_cast<int>(F(result.face_new_to_old[f], j))];
+        }
+    }, 1 << 12);
+    
+    return result;
+}
+
+#define UV_SEGMENTATION_INSTANTIATE(DerivedV, DerivedF) \
+    template WeldResult weldVertices<DerivedV, DerivedF>( \
+        const Eigen::MatrixBase<DerivedV>&, const Eigen::MatrixBase<DerivedF>&, double, \
+        PlainMatrix<DerivedV>&, PlainMatrix<DerivedF>&);
+UV_SEGMENTATION_MESH_TYPES(UV_SEGMENTATION_INSTANTIATE)
+#undef UV_SEGMENTATION_INSTANTIATE
+
+} // namespace UVSegmentation
@@ -0,0 +1,165 @@
+#include "uv_segmentation.h"
+#include "segmentation_internal.h"
+#include <igl/parallel_for.h>
+
+namespace UVSegmentation {
+
+template <typename DerivedV>
+TriangulatedPolygonMesh triangulatePolygonMesh(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const PolygonMesh& polygons
+) {
+    TriangulatedPolygonMesh mesh;
+    const int num_polygons = polygons.numFaces();
+    
+    // n 边形产生 n - 2 个三角形
+    mesh.triangle_offsets.assign(num_polygons + 1, 0);
+    for (int p = 0; p < num_polygons; ++p) {
+        mesh.triangle_offsets[p + 1] = mesh.triangle_offsets[p] + std::max(0, polygons.faceSize(p) - 2);
+    }
+    const int num_triangles = mesh.triangle_offsets[num_polygons];
+    
+    // 三角形 (v0, v[k+1], v[k+2])：第 1 个角总是多边形边，第 0 / 2 个角只在扇形两端是
+    mesh.F.resize(num_triangles, 3);
+    mesh.triangle_polygon.resize(num_triangles);
+    std::vector<uint8_t> corner_is_side(3 * static_cast<size_t>(num_triangles));
+    igl::parallel_for(num_polygons, [&](int p) {
+        const ConstSpan<int> vertices = polygons.faceVertices(p);
+        const int n = static_cast<int>(vertices.size());
+        for (int k = 0; k + 2 < n; ++k) {
+            const int t = mesh.triangle_offsets[p] + k;
+            mesh.F.row(t) << vertices[0], vertices[k + 1], vertices[k + 2];
+            mesh.triangle_polygon[t] = p;
+            corner_is_side[MeshTopology::corner(t, 0)] = k == 0;
+            corner_is_side[MeshTopology::corner(t, 1)] = 1;
+            corner_is_side[MeshTopology::corner(t, 2)] = k + 3 == n;
+        }
+    }, 1 << 12);
+    
+    mesh.topo = buildTopology(static_cast<int>(V.rows()), mesh.F);
+    
+    // 边上任一三角形的对应角是多边形边即为多边形边；每个任务写一个 64 位字
+    const MeshTopology& topo = mesh.topo;
+    mesh.polygon_edges = EdgeMask(topo.numEdges());
+    igl::parallel_for(mesh.polygon_edges.numWords(), [&](int w) {
+        const int begin = w * 64;
+        const int end = std::min(topo.numEdges(), begin + 64);
+        uint64_t word = 0;
+        for (int e = begin; e < end; ++e) {
+            for (HalfedgeIndex k = topo.edge_face_offsets[e]; k < topo.edge_face_offsets[e + 1]; ++k) {
+                const int t = topo.edge_faces[k];
+                bool side = false;
+                for (int i = 0; i < 3; ++i) {
+                    side = side || (topo.faceEdge(t, i) == e && corner_is_side[MeshTopology::corner(t, i)]);
+                }
+                if (side) {
+                    word |= uint64_t(1) << (e - begin);
+                    break;
+                }
+            }
+        }
+        mesh.polygon_edges.word(w) = word;
+    }, 16);
+    
+    return mesh;
+}
+
+namespace {
+
+/**
+ * @brief 顶点 v 处与多边形边 e 相对的多边形边
+ * 
+ * v 须为内部流形顶点且恰有 4 条多边形边，否则返回 -1。沿半边一环旋转，
+ * 跳过三角化对角线，相对边即旋转顺序上隔一条的边。
+ */
+int oppositeEdge(const TriangulatedPolygonMesh& mesh, int v, int e) {
+    const MeshTopology& topo = mesh.topo;
+    const HalfEdgeMesh& halfedges = topo.halfedges;
+    const HalfedgeIndex start = halfedges.vertex_halfedge[v];
+    if (start < 0 || halfedges.isBoundary(start)) return -1;
+    
+    int ring[4];
+    int count = 0;
+    int position = -1;
+    for (HalfedgeIndex h : halfedges.outgoing(v)) {
+        const int ei = halfedges.edge[h];
+        if (!mesh.polygon_edges.test(ei)) continue;
+        if (count == 4) return -1;
+        if (ei == e) position = count;
+        ring[count++] = ei;
+    }
+    if (count != 4 || position < 0) return -1;
+    
+    // 非流形顶点只旋转到一个扇区：与顶点的全部多边形边数比较
+    int total = 0;
+    for (HalfedgeIndex k = topo.vertex_edge_offsets[v]; k < topo.vertex_edge_offsets[v + 1]; ++k) {
+        if (mesh.polygon_edges.test(topo.vertex_edges[k])) ++total;
+    }
+    if (total != 4) return -1;
+    
+    return ring[(position + 2) % 4];
+}
+
+/**
+ * @brief 从顶点 v（经边 e 到达）继续行走，把经过的边和新顶点追加到输出
+ * 
+ * 返回是否回到了 stop_edge（闭合）。每条边至多经过一次，步数不超过边数。
+ */
+bool walkFrom(const TriangulatedPolygonMesh& mesh, int v, int e, int stop_edge,
+              std::vector<int>& vertices, std::vector<int>& edges) {
+    const MeshTopology& topo = mesh.topo;
+    for (int step = 0; step < topo.numEdges(); ++step) {
+        const int next = oppositeEdge(mesh, v, e);
+        if (next < 0) return false;
+        if (next == stop_edge) return true;
+        const Edge& edge = topo.edges[next];
+        v = edge.v0 == v ? edge.v1 : edge.v0;
+        e = next;
+        edges.push_back(e);
+        vertices.push_back(v);
+    }
+    return false;
+}
+
+} // namespace
+
+EdgeLoop walkEdgeLoop(
+    const TriangulatedPolygonMesh& mesh,
+    int seed_edge
+) {
+    EdgeLoop loop;
+    if (seed_edge < 0 || seed_edge >= mesh.topo.numEdges() || !mesh.polygon_edges.test(seed_edge)) {
+        return loop;
+    }
+    
+    // 向 v1 方向走；到达 v0 后下一条相对边就是种子边，末尾的 v0 不重复保存
+    const Edge& seed = mesh.topo.edges[seed_edge];
+    loop.vertices = {seed.v0, seed.v1};
+    loop.edges = {seed_edge};
+    if (walkFrom(mesh, seed.v1, seed_edge, seed_edge, loop.vertices, loop.edges)) {
+        loop.vertices.pop_back();
+        loop.closed = true;
+        return loop;
+    }
+    
+    // 开放：再向 v0 方向走，反转后接在前面
+    std::vector<int> back_vertices;
+    std::vector<int> back_edges;
+    walkFrom(mesh, seed.v0, seed_edge, seed_edge, back_vertices, back_edges);
+    back_vertices.insert(back_vertices.begin(), loop.vertices.rbegin(), loop.vertices.rend());
+    back_edges.insert(back_edges.begin(), loop.edges.rbegin(), loop.edges.rend());
+    std::reverse(back_vertices.begin(), back_vertices.end());
+    std::reverse(back_edges.begin(), back_edges.end());
+    loop.vertices.swap(back_vertices);
+    loop.edges.swap(back_edges);
+    
+    return loop;
+}
+
+#define UV_SEGMENTATION_INSTANTIATE(DerivedV) \
+    template TriangulatedPolygonMesh triangulatePolygonMesh<DerivedV>( \
+        const Eigen::MatrixBase<DerivedV>&, const PolygonMesh&);
+UV_SEGMENTATION_VERTEX_TYPES(UV_SEGMENTATION_INSTANTIATE)
+#undef UV_SEGMENTATION_INSTANTIATE
+
+} // namespace UVSegmentation
@@ -0,0 +1,102 @@
+#include "uv_segmentation.h"
+#include "segmentation_internal.h"
+#include <igl/parallel_for.h>
+
+namespace UVSegmentation {
+
+template <typename DerivedV>
+SeamGraph buildSeamGraph(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const MeshTopology& topo,
+    const IslandSet& islands,
+    const GeometryCache* geometry
+) {
+    const int num_edges = topo.numEdges();
+    
+    // 岛内切缝两侧属于同一岛，只能从切割边得知；分割时已记录则直接复用，
+    // 否则（由 UVIsland 重建等）从岛的边界边列表查回边 ID
+    EdgeMask rebuilt_cut_edges;
+    if (islands.cut_edges.size() != num_edges) {
+        rebuilt_cut_edges = EdgeMask(num_edges);
+        for (const Edge& e : islands.boundary) {
+            const int ei = topo.findEdge(e.v0, e.v1);
+            if (ei >= 0) rebuilt_cut_edges.set(ei);
+        }
+    }
+    const EdgeMask& cut_edges = islands.cut_edges.size() == num_edges ? islands.cut_edges : rebuilt_cut_edges;
+    
+    // 边 e 是否为缝合边；是则给出左右两侧的岛
+    auto classify = [&](int e, int& left, int& right) {
+        const HalfedgeIndex begin = topo.edge_face_offsets[e];
+        const HalfedgeIndex end = topo.edge_face_offsets[e + 1];
+        if (end - begin < 2) return false;
+        
+        const int first = topo.edge_faces[begin];
+        left = islands.face_island[first];
+        right = left;
+        for (HalfedgeIndex k = begin + 1; k < end && right == left; ++k) {
+            right = islands.face_island[topo.edge_faces[k]];
+        }
+        if (right == left && !cut_edges.test(e)) return false;
+        
+        // 第一个面中的半边若为 v1 -> v0，则它在右侧
+        for (int i = 0; i < 3; ++i) {
+            if (topo.faceEdge(first, i) == e) {
+                if (topo.halfedges.vertex[MeshTopology::corner(first, i)] != topo.edges[e].v0) {
+                    std::swap(left, right);
+                }
+                break;
+            }
+        }
+        return true;
+    };
+    
+    // 按块计数、前缀求和后按块写入，输出按边 ID 升序
+    const Chunks chunks(num_edges);
+    std::vector<int> chunk_offsets(chunks.count + 1, 0);
+    igl::parallel_for(static_cast<int>(chunks.count), [&](int c) {
+        int count = 0, left, right;
+        for (size_t e = chunks.begin(c, num_edges); e < chunks.end(c, num_edges); ++e) {
+            if (classify(static_cast<int>(e), left, right)) ++count;
+        }
+        chunk_offsets[c + 1] = count;
+    }, 1);
+    for (size_t c = 0; c < chunks.count; ++c) {
+        chunk_offsets[c + 1] += chunk_offsets[c];
+    }
+    
+    SeamGraph seams;
+    const int num_seams = chunk_offsets[chunks.count];
+    seams.edge_ids.resize(num_seams);
+    seams.edges.resize(num_seams);
+    seams.left_island.resize(num_seams);
+    seams.right_island.resize(num_seams);
+    seams.lengths.resize(num_seams);
+    
+    igl::parallel_for(static_cast<int>(chunks.count), [&](int c) {
+        int out = chunk_offsets[c], left, right;
+        for (size_t e = chunks.begin(c, num_edges); e < chunks.end(c, num_edges); ++e) {
+            if (!classify(static_cast<int>(e), left, right)) continue;
+            const Edge& edge = topo.edges[e];
+            seams.edge_ids[out] = static_cast<int>(e);
+            seams.edges[out] = edge;
+            seams.left_island[out] = left;
+            seams.right_island[out] = right;
+            seams.lengths[out] = geometry
+                ? geometry->edge_lengths[e]
+                : (V.row(edge.v0) - V.row(edge.v1)).template cast<double>().norm();
+            ++out;
+        }
+    }, 1);
+    
+    return seams;
+}
+
+#define UV_SEGMENTATION_INSTANTIATE(DerivedV) \
+    template SeamGraph buildSeamGraph<DerivedV>( \
+        const Eigen::MatrixBase<DerivedV>&, const MeshTopology&, const IslandSet&, \
+        const GeometryCache*);
+UV_SEGMENTATION_VERTEX_TYPES(UV_SEGMENTATION_INSTANTIATE)
+#undef UV_SEGMENTATION_INSTANTIATE
+
+} // namespace UVSegmentation
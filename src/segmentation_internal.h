@@ -0,0 +1,392 @@
+#pragma once
+
+#include "uv_segmentation.h"
+#include <igl/parallel_for.h>
+#include <Eigen/Geometry>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+/**
+ * @file segmentation_internal.h
+ * @brief 库内部共享的辅助函数（不属于公开 API）
+ */
+
+/**
+ * @brief 对每种支持的 (V, F) 组合展开 X(DerivedV, DerivedF)，用于显式实例化
+ */
+#define UV_SEGMENTATION_MESH_TYPES(X) \
+    X(Eigen::MatrixXf, Eigen::MatrixXi) \
+    X(Eigen::MatrixXd, Eigen::MatrixXi) \
+    X(Eigen::MatrixXd, UVSegmentation::MatrixXi64) \
+    X(UVSegmentation::VertexBufferView, UVSegmentation::IndexBufferView)
+
+/**
+ * @brief 对每种支持的面矩阵类型（含内部按面子集复制出的 PlainMatrix）展开 X(DerivedF)
+ */
+#define UV_SEGMENTATION_FACE_TYPES(X) \
+    X(Eigen::MatrixXi) \
+    X(UVSegmentation::MatrixXi64) \
+    X(UVSegmentation::IndexBufferView) \
+    X(UVSegmentation::PlainMatrix<UVSegmentation::IndexBufferView>)
+
+/**
+ * @brief 对每种支持的顶点矩阵类型展开 X(DerivedV)，用于只接受 V 的函数
+ */
+#define UV_SEGMENTATION_VERTEX_TYPES(X) \
+    X(Eigen::MatrixXf) \
+    X(Eigen::MatrixXd) \
+    X(UVSegmentation::VertexBufferView)
+
+namespace UVSegmentation {
+
+/**
+ * @brief 串行并查集（按集合大小合并，路径减半）
+ */
+class DisjointSets {
+public:
+    explicit DisjointSets(int n) : parent_(n), size_(n, 1) {
+        for (int i = 0; i < n; ++i) parent_[i] = i;
+    }
+    
+    int find(int x) {
+        while (parent_[x] != x) {
+            parent_[x] = parent_[parent_[x]];
+            x = parent_[x];
+        }
+        return x;
+    }
+    
+    // 合并两个根，返回新的根
+    int unite(int a, int b) {
+        if (size_[a] < size_[b]) std::swap(a, b);
+        parent_[b] = a;
+        size_[a] += size_[b];
+        return a;
+    }
+    
+private:
+    std::vector<int> parent_;
+    std::vector<int> size_;
+};
+
+/**
+ * @brief 将 [0, n) 划分为若干连续块，供按块并行的两趟算法使用
+ * 
+ * 块数只影响并行度；按块统计后再按块顺序前缀求和的算法，
+ * 结果与线程数无关。
+ */
+struct Chunks {
+    static constexpr size_t kMinChunkSize = 1 << 14;
+    
+    size_t count;
+    size_t size;
+    
+    explicit Chunks(size_t n);
+    
+    size_t begin(size_t c, size_t n) const { return std::min(n, c * size); }
+    size_t end(size_t c, size_t n) const { return std::min(n, (c + 1) * size); }
+};
+
+/**
+ * @brief 并行 LSD 基数排序（键 + 值），稳定排序
+ * 
+ * 每一轮各块统计本块直方图，按 (桶, 块) 顺序求前缀和后分散写入，
+ * 因此输出只取决于输入顺序，与线程数无关。只排序键的低 key_bits 位。
+ */
+template <typename Value>
+void radixSortPairs(std::vector<uint64_t>& keys, std::vector<Value>& values, int key_bits);
+
+/**
+ * @brief 把 double 的位模式映射为无符号整数，按整数比较即为数值顺序（供基数排序）
+ */
+inline uint64_t sortableKey(double x) {
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return (bits >> 63) ? ~bits : (bits | (uint64_t(1) << 63));
+}
+
+/**
+ * @brief 只依赖面矩阵的拓扑构建（buildMeshTopology 只用到 V 的行数）
+ */
+template <typename DerivedF>
+MeshTopology buildTopology(int num_vertices, const Eigen::MatrixBase<DerivedF>& F);
+
+/**
+ * @brief 根据已构建的边编号填充 topo.halfedges
+ */
+template <typename DerivedF>
+void buildHalfEdges(const Eigen::MatrixBase<DerivedF>& F, MeshTopology& topo);
+
+/**
+ * @brief 以 double 读取面 f 的第 i 个顶点（float 输入逐元素转换，不复制整个矩阵）
+ */
+template <typename DerivedV, typename DerivedF>
+inline Eigen::Vector3d cornerPosition(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    int f, int i
+) {
+    return V.row(F(f, i)).template cast<double>().transpose();
+}
+
+/**
+ * @brief 面 f 的 (面积·重心, 面积)，按面累加后得到岛的面积与质心
+ */
+template <typename DerivedV, typename DerivedF>
+inline Eigen::Vector4d faceAreaMoment(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    int f
+) {
+    const Eigen::Vector3d p0 = cornerPosition(V, F, f, 0);
+    const Eigen::Vector3d p1 = cornerPosition(V, F, f, 1);
+    const Eigen::Vector3d p2 = cornerPosition(V, F, f, 2);
+    const double area = 0.5 * (p1 - p0).cross(p2 - p0).norm();
+    Eigen::Vector4d moment;
+    moment << area * (p0 + p1 + p2) / 3.0, area;
+    return moment;
+}
+
+/**
+ * @brief 填写几何缓存的逐面部分（法向、面积、重心），不计算边长
+ */
+template <typename DerivedV, typename DerivedF>
+void computeFaceGeometry(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    GeometryCache& geometry
+);
+
+/**
+ * @brief 返回指向几何缓存的选项：options.geometry 为空时在 storage 中构建一次
+ * 
+ * 需要面法向或面积的分割算法用它保证整个流程只做一趟几何计算。
+ */
+template <typename DerivedV, typename DerivedF>
+SegmentationOptions withGeometry(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    const MeshTopology& topo,
+    const SegmentationOptions& options,
+    GeometryCache& storage
+) {
+    SegmentationOptions result = options;
+    if (!result.geometry) {
+        storage = buildGeometryCache(V, F, topo);
+        result.geometry = &storage;
+    }
+    return result;
+}
+
+/**
+ * @brief 一趟累加各岛的面积与面积加权质心，并把最长的边界环移到最前（外环）
+ * 
+ * 面 CSR 和边界环须已填好。各岛的面区间按固定大小分块，块内部分和并行计算，
+ * 再按块顺序合并，因此结果与线程数无关。面积为零的岛质心为原点。
+ * 给出 geometry 时直接读取缓存的面积和重心。
+ */
+template <typename DerivedV, typename DerivedF>
+void computeIslandStatistics(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const Eigen::MatrixBase<DerivedF>& F,
+    IslandSet& islands,
+    const GeometryCache* geometry = nullptr
+) {
+    constexpr int kBlockSize = 1 << 12;
+    const int num_islands = islands.numIslands();
+    
+    struct Block {
+        int island;
+        int begin;
+        int end;
+    };
+    std::vector<Block> blocks;
+    for (int i = 0; i < num_islands; ++i) {
+        const int end = islands.face_offsets[i + 1];
+        for (int b = islands.face_offsets[i]; b < end; b += kBlockSize) {
+            blocks.push_back({i, b, std::min(end, b + kBlockSize)});
+        }
+    }
+    
+    // 每块的 (Σ 面积·重心, Σ 面积)
+    std::vector<Eigen::Vector4d> partial(blocks.size());
+    igl::parallel_for(static_cast<int>(blocks.size()), [&](int k) {
+        Eigen::Vector4d sum = Eigen::Vector4d::Zero();
+        for (int j = blocks[k].begin; j < blocks[k].end; ++j) {
+            const int f = islands.faces[j];
+            if (geometry) {
+                sum.head<3>() += geometry->areas(f) * geometry->barycenters.row(f).transpose();
+                sum(3) += geometry->areas(f);
+            } else {
+                sum += faceAreaMoment(V, F, f);
+            }
+        }
+        partial[k] = sum;
+    }, 1);
+    
+    islands.centroids.assign(num_islands, Eigen::Vector3d::Zero());
+    islands.areas.assign(num_islands, 0.0);
+    for (size_t k = 0; k < blocks.size(); ++k) {
+        islands.centroids[blocks[k].island] += partial[k].head<3>();
+        islands.areas[blocks[k].island] += partial[k](3);
+    }
+    for (int i = 0; i < num_islands; ++i) {
+        if (islands.areas[i] > 0) islands.centroids[i] /= islands.areas[i];
+    }
+    
+    // 外环：三维长度最长的环，旋转到本岛环区间的最前面
+    igl::parallel_for(num_islands, [&](int i) {
+        const int first = islands.island_loop_offsets[i];
+        const int count = islands.numLoops(i);
+        if (count < 2) return;
+        
+        int outer = 0;
+        double outer_length = -1.0;
+        for (int k = 0; k < count; ++k) {
+            const ConstSpan<int> loop = islands.islandLoop(i, k);
+            double length = 0.0;
+            for (size_t j = 0; j < loop.size(); ++j) {
+                const int a = loop[j];
+                const int b = loop[(j + 1) % loop.size()];
+                length += (V.row(a) - V.row(b)).template cast<double>().norm();
+            }
+            if (length > outer_length) {
+                outer = k;
+                outer_length = length;
+            }
+        }
+        if (outer == 0) return;
+        
+        std::vector<HalfedgeIndex>& offsets = islands.loop_offsets;
+        const HalfedgeIndex begin = offsets[first];
+        const HalfedgeIndex outer_begin = offsets[first + outer];
+        const HalfedgeIndex outer_end = offsets[first + outer + 1];
+        std::rotate(islands.loop_vertices.begin() + begin,
+                    islands.loop_vertices.begin() + outer_begin,
+                    islands.loop_vertices.begin() + outer_end);
+        for (int k = outer; k > 0; --k) {
+            offsets[first + k] = offsets[first + k - 1] + (outer_end - outer_begin);
+        }
+    }, 1 << 8);
+}
+
+/**
+ * @brief 沿半边追踪每个岛的闭合边界环，填写 island_loop_offsets/loop_offsets/loop_vertices
+ * 
+ * 需要 face_island 和面 CSR。岛的边界半边是对面不属于本岛（网格边界或其他岛）
+ * 或所在边为切割边的内部半边；从一条边界半边出发，绕其终点旋转找到下一条，
+ * 总代价与边界长度（乘以顶点度数）成正比。
+ */
+void traceBoundaryLoops(
+    const MeshTopology& topo,
+    const EdgeMask& cut_edges,
+    IslandSet& islands
+);
+
+/**
+ * @brief 填写岛邻接图 CSR（neighbor_offsets/neighbors/shared_edges/shared_lengths）
+ * 
+ * 需要 face_island。按块并行统计跨岛的边，以岛对为键稳定基数排序后合并，
+ * 结果与线程数无关；代价与边数加缝合边数成正比。给出 geometry 时边长取自缓存。
+ */
+template <typename DerivedV>
+void buildIslandAdjacency(
+    const Eigen::MatrixBase<DerivedV>& V,
+    const MeshTopology& topo,
+    IslandSet& islands,
+    const GeometryCache* geometry = nullptr
+);
+
+/**
+ * @brief 逐岛回调：岛 ID、面（BFS 顺序）、岛内切割边
+ */
+using IslandFaceVisitor = std::function<void(int, const std::vector<int>&, const std::vector<Edge>&)>;
+
+/**
+ * @brief 串行 BFS 划分 UV 岛，每个岛完成后立即回调
+ * 
+ * 面和边界边缓冲区在岛之间复用，回调返回后即被覆盖。face_to_island 兼作访问标记，
+ * 结束时为完整的面标签。岛按最小面索引升序编号；非流形边连接其上的所有面。
+ */
+void visitIslandsBreadthFirst(
+    const MeshTopology& topo,
+    const EdgeMask& cut_edges,
+    std::vector<int>& face_to_island,
+    const IslandFaceVisitor& visit
+);
+
+/**
+ * @brief 由每个面所在分量的根（分量中的最小面）生成面标签、面 CSR 和边界边 CSR
+ * 
+ * 岛按根升序编号，岛内面按索引升序；边界边为 cut_edges 中落在岛内面上的边，
+ * cut_edges 本身也存入结果。各步按块并行，结果与线程数无关。不填写边界环和统计量。
+ */
+IslandSet islandsFromRoots(
+    const MeshTopology& topo,
+    const EdgeMask& cut_edges,
+    const std::vector<int>& root
+);
+
+/**
+ * @brief 从 v 沿链边 e 串联一条链，经过链边数为 2 的顶点，直到端点、分叉点或回到起点
+ * 
+ * valence 为每个顶点上的链边数；is_free(e) 判断 e 是否为尚未归入任何链的链边，
+ * 经过每条边时调用 claim(e)。从分叉点出发又回到同一点的链也标记为闭合。
+ */
+template <typename IsFree, typename Claim>
+EdgeLoop walkChain(
+    const MeshTopology& topo,
+    const std::vector<int>& valence,
+    int v,
+    int e,
+    const IsFree& is_free,
+    const Claim& claim
+) {
+    EdgeLoop loop;
+    loop.vertices.push_back(v);
+    while (true) {
+        claim(e);
+        loop.edges.push_back(e);
+        const Edge& edge = topo.edges[e];
+        v = (edge.v0 == v) ? edge.v1 : edge.v0;
+        if (valence[v] != 2) {
+            loop.vertices.push_back(v);
+            break;
+        }
+        
+        int next = -1;
+        for (HalfedgeIndex k = topo.vertex_edge_offsets[v]; k < topo.vertex_edge_offsets[v + 1]; ++k) {
+            if (is_free(topo.vertex_edges[k])) {
+                next = topo.vertex_edges[k];
+                break;
+            }
+        }
+        if (next < 0) {
+            // 回到了纯 2 度环的起点
+            loop.closed = true;
+            break;
+        }
+        loop.vertices.push_back(v);
+        e = next;
+    }
+    
+    if (!loop.closed && loop.vertices.size() > 2 && loop.vertices.front() == loop.vertices.back()) {
+        loop.vertices.pop_back();
+        loop.closed = true;
+    }
+    return loop;
+}
+
+/**
+ * @brief 按切割边划分 UV 岛，填写面标签、面 CSR、边界边 CSR 和边界环（不含统计量）
+ * 
+ * 岛按最小面索引升序编号；非流形边连接其上的所有面。
+ */
+IslandSet labelIslands(
+    const MeshTopology& topo,
+    const EdgeMask& cut_edges,
+    IslandLabeling labeling
+);
+
+} // namespace UVSegmentation